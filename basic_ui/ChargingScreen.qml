@@ -59,6 +59,7 @@ Rectangle {
     ParallelAnimation {
         id: resetClock
         objectName: "resetClock"
+        Component.onCompleted: config.registerQMLObject(objectName, this)
         running: false
 
         PropertyAnimation { target: batteryIcon; properties: "x"; to: (parent.width-implicitWidth)/2; duration: 1 }
@@ -73,6 +74,7 @@ Rectangle {
     SequentialAnimation {
         id: showClock
         objectName: "showClock"
+        Component.onCompleted: config.registerQMLObject(objectName, this)
         running: false
 
         PauseAnimation {duration: 3000}
@@ -120,6 +120,22 @@ Rectangle {
     }
 
 
+    // integration loading progress
+    Rectangle {
+        id: loadingProgress
+        width: parent.width * integrations.loadProgress
+        height: 4
+        color: Style.color.highlight1
+        opacity: loadingScreenComp.state == "start" ? 1 : 0
+
+        anchors {
+            left: parent.left
+            bottom: parent.bottom
+        }
+
+        Behavior on width { NumberAnimation { duration: 300; easing.type: Easing.OutExpo } }
+    }
+
     Image {
         asynchronous: true
         id: yio_Y
@@ -40,6 +40,14 @@ Rectangle {
         addHours();
     }
 
+    // the screen times are calculated on demand, refresh them while they are shown
+    Timer {
+        interval: 1000
+        repeat: true
+        running: container.visible
+        onTriggered: StandbyControl.refreshScreenTime()
+    }
+
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // VARIABLES
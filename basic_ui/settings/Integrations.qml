@@ -143,7 +143,7 @@ Rectangle {
 
                         onClicked: {
                             Haptic.playEffect(Haptic.Click);
-                            obj.connect();
+                            integrations.invoke(obj, "connect");
                             popup.close();
                         }
                     }
@@ -173,7 +173,7 @@ Rectangle {
                         enabled: obj.state == 2 ? false : true
                         onClicked: {
                             Haptic.playEffect(Haptic.Click);
-                            obj.disconnect();
+                            integrations.invoke(obj, "disconnect");
                             popup.close();
                         }
                     }
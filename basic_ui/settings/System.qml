@@ -234,6 +234,7 @@ Rectangle {
                     // TODO create a framebuffer device class instead of launching hard coded shell scripts from QML
                     settingsLauncher.launch("fbv -d 1 $YIO_MEDIA_DIR/splash/bye.png")
                     console.debug("now reboot")
+                    config.flush();
                     // TODO create a device class for system reboot instead of launching hard coded shell scripts from QML
                     settingsLauncher.launch("reboot");
                 }
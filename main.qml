@@ -255,7 +255,7 @@ ApplicationWindow {
 
             // signal with the dock that it is low battery
             var obj = integrations.get(config.settings.paired_dock);
-            obj.onLowBattery();
+            integrations.invoke(obj, "onLowBattery");
         }
     }
 
@@ -343,6 +343,7 @@ ApplicationWindow {
     Loader {
         id: loadingScreen
         objectName: "loadingScreen"
+        Component.onCompleted: config.registerQMLObject(objectName, this)
         visible: StandbyControl.mode == StandbyControl.ON || StandbyControl.mode == StandbyControl.DIM
         width: parent.width; height: parent.height
 
@@ -413,6 +414,7 @@ ApplicationWindow {
     MouseArea {
         id: touchEventCatcher
         objectName: "touchEventCatcher"
+        Component.onCompleted: config.registerQMLObject(objectName, this)
         anchors.fill: parent
         enabled: false
         pressAndHoldInterval: 5000
@@ -120,13 +120,18 @@ HEADERS += \
     sources/hardware/proximitysensor.h \
     sources/hardware/mock/proximitysensor_mock.h \
     sources/integrations/integrations.h \
+    sources/integrations/integrationscheduler.h \
     sources/integrations/integrations_supported.h \
     sources/integrations/integrationsinterface.h \
     sources/jsonfile.h \
     sources/launcher.h \
+    sources/binarylog.h \
     sources/logger.h \
+    sources/ringbuffer.h \
     sources/softwareupdate.h \
     sources/standbycontrol.h \
+    sources/wakebenchmark.h \
+    sources/wakelatency.h \
     sources/translation.h \
     sources/hardware/device.h \
     sources/hardware/touchdetect.h \
@@ -170,6 +175,8 @@ SOURCES += \
     sources/hardware/hardwarefactory_default.cpp \
     sources/hardware/touchdetect.cpp \
     sources/integrations/integrations.cpp \
+    sources/integrations/integrationscheduler.cpp \
+    sources/binarylog.cpp \
     sources/logger.cpp \
     sources/main.cpp \
     sources/jsonfile.cpp \
@@ -190,6 +197,8 @@ SOURCES += \
     sources/bluetootharea.cpp \
     sources/softwareupdate.cpp \
     sources/standbycontrol.cpp \
+    sources/wakebenchmark.cpp \
+    sources/wakelatency.cpp \
     sources/translation.cpp \
     sources/utils.cpp \
     sources/yioapi.cpp
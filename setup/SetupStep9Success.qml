@@ -64,6 +64,7 @@ Item {
             // delete /firstrun
             console.debug("Deleting /firstrun success: " + fileio.deleteFile("/firstrun"));
             // reboot remote
+            config.flush();
             myLauncher.launch("reboot");
         }
     }
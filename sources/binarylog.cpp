@@ -0,0 +1,358 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include "binarylog.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+const char* BinaryLog::FILE_PATTERN = "*.ylog";
+const char* BinaryLog::INDEX_PATTERN = "*.ylog.idx";
+
+static const int    INDEX_VERSION = 1;
+static const qint64 MSECS_PER_HOUR = 3600000;
+
+BinaryLog::BinaryLog(const QString& directory)
+    : m_directory(directory), m_file(nullptr), m_hour(-1), m_lastBlock(0), m_indexSize(0), m_indexTime(0) {}
+
+BinaryLog::~BinaryLog() {
+    flush();
+    closeSegment();
+}
+
+void BinaryLog::append(qint64 timestamp, QtMsgType type, const QString& category, const QString& source,
+                       const QString& message) {
+    // messages of other threads may arrive slightly out of order, they stay in the current segment
+    qint64 hour = timestamp / MSECS_PER_HOUR;
+    if (hour > m_hour) {
+        flush();
+        closeSegment();
+        openSegment(timestamp);
+    }
+    if (m_file == nullptr) {
+        return;
+    }
+
+    Message record;
+    record.timestamp = timestamp;
+    record.type = type;
+    record.category = defineName(RECORD_CATEGORY, category, &m_categoryIds, &m_segment.categories);
+    record.source = source.isEmpty() ? NO_SOURCE : defineName(RECORD_SOURCE, source, &m_sourceIds, &m_segment.sources);
+    record.message = message.toUtf8();
+    record.offset = m_segment.size + m_records.size();
+    if (m_segment.blocks.isEmpty() || record.offset - m_lastBlock >= BLOCK_SIZE) {
+        m_segment.blocks.append(qMakePair(timestamp, record.offset));
+        m_lastBlock = record.offset;
+    }
+
+    QDataStream stream(&m_records, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << static_cast<quint8>(type) << timestamp << record.category << record.source << record.message;
+    m_segment.add(record);
+}
+
+void BinaryLog::flush() {
+    if (m_file == nullptr || m_records.isEmpty()) {
+        return;
+    }
+    m_file->write(m_records);
+    m_file->flush();
+    m_records.clear();
+    m_segment.size = m_file->size();
+
+    // readers scan a segment with an outdated index completely, queries write the index before they read
+    if (QDateTime::currentMSecsSinceEpoch() - m_indexTime >= INDEX_INTERVAL) {
+        writeIndex();
+    }
+}
+
+void BinaryLog::writeIndex() {
+    if (m_file == nullptr || m_indexSize == m_segment.size) {
+        return;
+    }
+    m_indexTime = QDateTime::currentMSecsSinceEpoch();
+
+    // the index is replaced atomically, readers see the previous or the new one
+    QSaveFile index(m_file->fileName() + ".idx");
+    if (index.open(QIODevice::WriteOnly)) {
+        index.write(QJsonDocument(m_segment.toIndex()).toJson(QJsonDocument::Compact));
+        if (index.commit()) {
+            m_indexSize = m_segment.size;
+        }
+    }
+}
+
+void BinaryLog::openSegment(qint64 timestamp) {
+    m_hour = timestamp / MSECS_PER_HOUR;
+    m_segment = Segment();
+    m_categoryIds.clear();
+    m_sourceIds.clear();
+    m_lastBlock = 0;
+
+    QDateTime dt = QDateTime::fromMSecsSinceEpoch(m_hour * MSECS_PER_HOUR, Qt::UTC);
+    QFile*    file = new QFile(QString("%1/%2.ylog").arg(m_directory, dt.toString("yyyy-MM-dd-hh")));
+    if (!file->open(QIODevice::ReadWrite)) {
+        delete file;
+        return;
+    }
+
+    // a segment of the same hour is continued after a restart, with the ids it already defined
+    m_indexSize = 0;
+    if (file->size() > 0 && m_segment.readIndex(file->fileName() + ".idx", file->size())) {
+        m_indexSize = file->size();
+    } else if (file->size() > 0) {
+        qint64 end = readRecords(file, &m_segment, [this](const Message& message) {
+            if (m_segment.blocks.isEmpty() || message.offset - m_lastBlock >= BLOCK_SIZE) {
+                m_segment.blocks.append(qMakePair(message.timestamp, message.offset));
+                m_lastBlock = message.offset;
+            }
+            m_segment.add(message);
+            return true;
+        });
+        file->resize(end);  // an incomplete record of a crash would corrupt the appended records
+    }
+    for (int i = 0; i < m_segment.categories.length(); i++) {
+        m_categoryIds.insert(m_segment.categories[i], static_cast<quint16>(i));
+    }
+    for (int i = 0; i < m_segment.sources.length(); i++) {
+        m_sourceIds.insert(m_segment.sources[i], static_cast<quint16>(i));
+    }
+    if (!m_segment.blocks.isEmpty()) {
+        m_lastBlock = m_segment.blocks.last().second;
+    }
+    file->seek(file->size());
+    m_segment.size = file->size();
+    m_file = file;
+}
+
+void BinaryLog::closeSegment() {
+    if (m_file != nullptr) {
+        writeIndex();
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+}
+
+quint16 BinaryLog::defineName(RecordType recordType, const QString& name, QHash<QString, quint16>* ids,
+                              QStringList* names) {
+    auto iter = ids->constFind(name);
+    if (iter != ids->constEnd()) {
+        return iter.value();
+    }
+    quint16 id = static_cast<quint16>(names->length());
+    names->append(name);
+    ids->insert(name, id);
+
+    QDataStream stream(&m_records, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << static_cast<quint8>(recordType) << id << name.toUtf8();
+    return id;
+}
+
+qint64 BinaryLog::readRecords(QFile* file, Segment* segment, const std::function<bool(const Message&)>& visitor) {
+    QDataStream stream(file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    qint64 end = file->pos();
+    while (!stream.atEnd()) {
+        qint64 offset = file->pos();
+        quint8 recordType;
+        stream >> recordType;
+        if (recordType == RECORD_CATEGORY || recordType == RECORD_SOURCE) {
+            quint16    id;
+            QByteArray name;
+            stream >> id >> name;
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+            // names which are already known from the index are defined again when the whole segment is read
+            QStringList* names = recordType == RECORD_CATEGORY ? &segment->categories : &segment->sources;
+            if (id == names->length()) {
+                names->append(QString::fromUtf8(name));
+            }
+            end = file->pos();
+        } else if (recordType <= QtInfoMsg) {
+            Message message;
+            message.offset = offset;
+            message.type = static_cast<QtMsgType>(recordType);
+            stream >> message.timestamp >> message.category >> message.source >> message.message;
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+            end = file->pos();
+            if (!visitor(message)) {
+                break;
+            }
+        } else {
+            break;  // not a record, the rest of the segment is unreadable
+        }
+    }
+    return end;
+}
+
+QJsonArray BinaryLog::query(const QString& directory, qint64 from, qint64 to, int logLevelMask,
+                            const QStringList& categories, int maxCount) {
+    QJsonArray  array;
+    QDir        dir(directory);
+    QStringList fileNames = dir.entryList(QStringList(FILE_PATTERN), QDir::Files, QDir::Name);
+    for (const QString& fileName : fileNames) {
+        if (array.count() >= maxCount) {
+            break;
+        }
+        // the file name is the hour of the segment
+        QDateTime hour = QDateTime::fromString(fileName.left(fileName.indexOf('.')), "yyyy-MM-dd-hh");
+        hour.setTimeSpec(Qt::UTC);
+        if (!hour.isValid() || hour.toMSecsSinceEpoch() > to + MAX_SKEW ||
+            hour.toMSecsSinceEpoch() + MSECS_PER_HOUR + MAX_SKEW <= from) {
+            continue;
+        }
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        Segment segment;
+        if (segment.readIndex(file.fileName() + ".idx", file.size())) {
+            if (segment.start > to || segment.end < from || !(segment.levels & logLevelMask)) {
+                continue;
+            }
+            bool found = categories.isEmpty();
+            for (int i = 0; !found && i < segment.categories.length(); i++) {
+                found = categories.contains(segment.categories[i]) && (segment.categoryLevels[i] & logLevelMask);
+            }
+            if (!found) {
+                continue;
+            }
+            // start at the last block which certainly has no requested message before it
+            qint64 offset = 0;
+            for (const auto& block : segment.blocks) {
+                if (block.first >= from - MAX_SKEW) {
+                    break;
+                }
+                offset = block.second;
+            }
+            file.seek(offset);
+        }
+
+        QVector<qint8> requested;  // by category id, -1 not yet known
+        readRecords(&file, &segment, [&](const Message& message) {
+            if (message.timestamp > to + MAX_SKEW) {
+                return false;
+            }
+            if (message.timestamp < from || message.timestamp > to || !(logLevelMask & (1 << message.type))) {
+                return true;
+            }
+            while (message.category >= requested.size()) {
+                requested.append(-1);
+            }
+            if (requested[message.category] < 0) {
+                requested[message.category] =
+                    categories.isEmpty() || categories.contains(segment.categories.value(message.category));
+            }
+            if (!requested[message.category]) {
+                return true;
+            }
+            QJsonObject obj;
+            obj.insert("type", message.type);
+            obj.insert("cat", segment.categories.value(message.category));
+            obj.insert("time", static_cast<double>(message.timestamp));
+            obj.insert("msg", QString::fromUtf8(message.message));
+            if (message.source != NO_SOURCE) {
+                obj.insert("src", segment.sources.value(message.source));
+            }
+            array.append(obj);
+            return array.count() < maxCount;
+        });
+    }
+    return array;
+}
+
+void BinaryLog::Segment::add(const Message& message) {
+    if (categoryCounts.size() <= message.category) {
+        categoryCounts.resize(message.category + 1);
+        categoryLevels.resize(message.category + 1);
+    }
+    categoryCounts[message.category]++;
+    categoryLevels[message.category] |= 1 << message.type;
+    levels |= 1 << message.type;
+    start = start == 0 ? message.timestamp : qMin(start, message.timestamp);
+    end = qMax(end, message.timestamp);
+}
+
+bool BinaryLog::Segment::readIndex(const QString& fileName, qint64 fileSize) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index.value("version").toInt() != INDEX_VERSION ||
+        static_cast<qint64>(index.value("size").toDouble()) != fileSize) {
+        return false;
+    }
+    size = fileSize;
+    levels = index.value("levels").toInt();
+    start = static_cast<qint64>(index.value("start").toDouble());
+    end = static_cast<qint64>(index.value("end").toDouble());
+    for (const QJsonValue& value : index.value("categories").toArray()) {
+        QJsonObject category = value.toObject();
+        categories.append(category.value("name").toString());
+        categoryCounts.append(category.value("count").toInt());
+        categoryLevels.append(category.value("levels").toInt());
+    }
+    for (const QJsonValue& value : index.value("sources").toArray()) {
+        sources.append(value.toString());
+    }
+    for (const QJsonValue& value : index.value("blocks").toArray()) {
+        QJsonArray block = value.toArray();
+        blocks.append(
+            qMakePair(static_cast<qint64>(block.at(0).toDouble()), static_cast<qint64>(block.at(1).toDouble())));
+    }
+    return true;
+}
+
+QJsonObject BinaryLog::Segment::toIndex() const {
+    QJsonObject index;
+    index.insert("version", INDEX_VERSION);
+    index.insert("size", static_cast<double>(size));
+    index.insert("levels", levels);
+    index.insert("start", static_cast<double>(start));
+    index.insert("end", static_cast<double>(end));
+    QJsonArray categoryArray;
+    for (int i = 0; i < categories.length(); i++) {
+        QJsonObject category;
+        category.insert("name", categories[i]);
+        category.insert("count", categoryCounts.value(i));
+        category.insert("levels", categoryLevels.value(i));
+        categoryArray.append(category);
+    }
+    index.insert("categories", categoryArray);
+    index.insert("sources", QJsonArray::fromStringList(sources));
+    QJsonArray blockArray;
+    for (const auto& block : blocks) {
+        blockArray.append(QJsonArray({static_cast<double>(block.first), static_cast<double>(block.second)}));
+    }
+    index.insert("blocks", blockArray);
+    return index;
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+#include <functional>
+
+/**
+ * @brief Structured log in hourly binary segments with an index per segment.
+ * A segment yyyy-MM-dd-hh.ylog (UTC) is a sequence of records: a message record holds the timestamp, the message type,
+ * the category id, the source position id and the message. Category names and source positions are defined once per
+ * segment by definition records. The index yyyy-MM-dd-hh.ylog.idx holds the time range, the categories with their
+ * message types and counts, and the file offset of a record every BLOCK_SIZE bytes. A query skips segments outside of
+ * the time range or without the requested categories and levels, and seeks to the block of its start time.
+ */
+class BinaryLog {
+ public:
+    explicit BinaryLog(const QString& directory);
+    ~BinaryLog();
+
+    // writer thread only, records are buffered until flush
+    void append(qint64 timestamp, QtMsgType type, const QString& category, const QString& source,
+                const QString& message);
+    // writes the buffered records, the index of the segment only every INDEX_INTERVAL
+    void flush();
+    // writes the index of the open segment if it does not cover all written records, e.g. before a query
+    void writeIndex();
+
+    /**
+     * @brief Query the log segments of a directory, from any thread
+     * @param from Start time, unix time in ms
+     * @param to End time, unix time in ms
+     * @param logLevelMask Bit (1 << QtMsgType) for every requested message type
+     * @param categories Requested categories, all if empty
+     * @param maxCount Maximum number of messages, the oldest messages are returned first
+     * @return Messages as objects with type, cat, time (unix time in ms), msg and src
+     */
+    static QJsonArray query(const QString& directory, qint64 from, qint64 to, int logLevelMask,
+                            const QStringList& categories, int maxCount);
+
+    static const char* FILE_PATTERN;   // segment files
+    static const char* INDEX_PATTERN;  // index files
+
+ private:
+    enum RecordType { RECORD_CATEGORY = 0xF0, RECORD_SOURCE = 0xF1 };  // message records use the QtMsgType
+
+    static const int     BLOCK_SIZE = 16384;      // bytes between two entries of the block index
+    static const quint16 NO_SOURCE = 0xFFFF;      // source id of messages without a source position
+    static const qint64  MAX_SKEW = 1000;         // ms, messages of different threads are not strictly in time order
+    static const qint64  INDEX_INTERVAL = 60000;  // ms between two index writes of the open segment
+
+    struct Message {
+        qint64     offset;  // file offset of the record
+        qint64     timestamp;
+        QtMsgType  type;
+        quint16    category;
+        quint16    source;
+        QByteArray message;  // UTF-8
+    };
+
+    // contents of the index, the writer keeps it up to date
+    struct Segment {
+        Segment() : levels(0), start(0), end(0), size(0) {}
+        QStringList                    categories;      // by category id
+        QVector<int>                   categoryCounts;  // by category id
+        QVector<int>                   categoryLevels;  // by category id, bit (1 << QtMsgType)
+        QStringList                    sources;         // by source id
+        int                            levels;          // bit (1 << QtMsgType)
+        qint64                         start;           // first timestamp
+        qint64                         end;             // last timestamp
+        qint64                         size;            // bytes of the segment file covered by the index
+        QVector<QPair<qint64, qint64>> blocks;          // timestamp, file offset
+
+        void        add(const Message& message);
+        bool        readIndex(const QString& fileName, qint64 fileSize);  // false if missing or outdated
+        QJsonObject toIndex() const;
+    };
+
+    // reads the records from the current position of the file, definitions are added to the segment and messages are
+    // passed to the visitor until it returns false, returns the end of the last complete record
+    static qint64 readRecords(QFile* file, Segment* segment, const std::function<bool(const Message&)>& visitor);
+
+    void    openSegment(qint64 timestamp);
+    void    closeSegment();
+    quint16 defineName(RecordType recordType, const QString& name, QHash<QString, quint16>* ids, QStringList* names);
+
+    QString                 m_directory;
+    QFile*                  m_file;
+    qint64                  m_hour;     // hours since epoch of the open segment
+    QByteArray              m_records;  // appended, not yet written records
+    Segment                 m_segment;
+    QHash<QString, quint16> m_categoryIds;
+    QHash<QString, quint16> m_sourceIds;
+    qint64                  m_lastBlock;  // file offset of the last block
+    qint64                  m_indexSize;  // segment size covered by the written index
+    qint64                  m_indexTime;  // unix time in ms of the last index write
+};
@@ -27,7 +27,8 @@
 
 #include "jsonfile.h"
 
-CommandLineHandler::CommandLineHandler(QObject *parent) : QObject(parent), m_profile("") {}
+CommandLineHandler::CommandLineHandler(QObject *parent)
+    : QObject(parent), m_profile(""), m_wakeBenchmark(0), m_wakeLimit(0) {}
 
 void CommandLineHandler::process(const QCoreApplication &app, const QString &defaultConfigPath) {
     QCommandLineParser parser;
@@ -48,6 +49,10 @@ void CommandLineHandler::process(const QCoreApplication &app, const QString &def
 
     // Commands: execute & exit
     QCommandLineOption validateOption(QStringList() << "validate", tr("Validate json configuration files and exit."));
+    QCommandLineOption wakeBenchmarkOption(QStringList() << "wake-benchmark",
+                                           tr("Replay wake events with the mock hardware and exit."), "ITERATIONS");
+    QCommandLineOption wakeLimitOption(QStringList() << "wake-limit",
+                                       tr("Fail the wake benchmark if a first frame takes longer."), "MS");
 
     parser.addOption(profileOption);
 
@@ -57,6 +62,8 @@ void CommandLineHandler::process(const QCoreApplication &app, const QString &def
     parser.addOption(hwCfgSchemaOpt);
 
     parser.addOption(validateOption);
+    parser.addOption(wakeBenchmarkOption);
+    parser.addOption(wakeLimitOption);
 
     parser.process(app);
 
@@ -101,6 +108,13 @@ void CommandLineHandler::process(const QCoreApplication &app, const QString &def
         m_hwCfgSchemaFile = parser.value(hwCfgSchemaOpt);
     }
 
+    if (parser.isSet(wakeBenchmarkOption)) {
+        m_wakeBenchmark = parser.value(wakeBenchmarkOption).toInt();
+    }
+    if (parser.isSet(wakeLimitOption)) {
+        m_wakeLimit = parser.value(wakeLimitOption).toInt();
+    }
+
     if (parser.isSet(validateOption)) {
         bool valid = validateJson(m_cfgFile, m_cfgSchemaFile);
         valid &= validateJson(m_hwCfgFile, m_hwCfgSchemaFile);
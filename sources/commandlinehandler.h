@@ -40,6 +40,9 @@ class CommandLineHandler : public QObject {
     QString hardwareConfigFile() { return m_hwCfgFile; }
     QString hardwareConfigSchemaFile() { return m_hwCfgSchemaFile; }
 
+    int wakeBenchmark() { return m_wakeBenchmark; }  // iterations, 0 means no benchmark
+    int wakeLimit() { return m_wakeLimit; }          // ms, 0 means no limit
+
  private:
     bool validateJson(const QString &filePath, const QString &schemaPath);
 
@@ -50,4 +53,6 @@ class CommandLineHandler : public QObject {
     QString m_cfgSchemaFile;
     QString m_hwCfgFile;
     QString m_hwCfgSchemaFile;
+    int     m_wakeBenchmark;
+    int     m_wakeLimit;
 };
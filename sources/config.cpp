@@ -23,9 +23,18 @@
 
 #include "config.h"
 
+#include <QCoreApplication>
+#include <QFile>
 #include <QJsonDocument>
+#include <QJsonValue>
 #include <QLoggingCategory>
 
+#include "configutil.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
 static Q_LOGGING_CATEGORY(CLASS_LC, "config");
 
 const QString Config::KEY_ID                 = CFG_KEY_ID;
@@ -49,9 +58,23 @@ Config::Config(QQmlApplicationEngine *engine, QString configFilePath, QString sc
 
     m_jsf = new JsonFile();
     m_jsf->setSchemaPath(schemaFilePath);
+    m_jsf->setChecksumEnabled(true);
 
     m_tf = new JsonFile();
 
+    // serialize and write the configuration on a worker thread
+    m_writer = new ConfigWriter(schemaFilePath);
+    m_writer->moveToThread(&m_writerThread);
+    connect(&m_writerThread, &QThread::finished, m_writer, &QObject::deleteLater);
+    connect(m_writer, &ConfigWriter::writeDone, this, &Config::onWriteDone);
+    m_writerThread.start();
+
+    m_writeTimer = new QTimer(this);
+    m_writeTimer->setSingleShot(true);
+    m_writeTimer->setInterval(WRITE_DELAY);
+    connect(m_writeTimer, &QTimer::timeout, this, &Config::onWriteTimeout);
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &Config::flush);
+
     s_instance = this;
 
     // load the config file
@@ -63,7 +86,15 @@ Config::Config(QQmlApplicationEngine *engine, QString configFilePath, QString sc
     m_languages = m_tf->read().toList();
 }
 
-Config::~Config() { s_instance = nullptr; }
+Config::~Config() {
+    flush();
+    s_instance = nullptr;
+
+    if (m_writerThread.isRunning()) {
+        m_writerThread.exit();
+        m_writerThread.wait(5000);
+    }
+}
 
 void Config::setFavorite(const QString &entityId, bool value) {
     QStringList fav = profileFavorites();
@@ -77,7 +108,7 @@ void Config::setFavorite(const QString &entityId, bool value) {
     }
 
     m_cacheUIProfile.insert("favorites", fav);
-    writeConfig();
+    scheduleWrite({"ui_config"});
     emit profileFavoritesChanged();
 }
 
@@ -87,10 +118,84 @@ void Config::setConfig(const QVariantMap &config) {
         return;
     }
 
+    QVariantMap changes = ConfigUtil::createMergePatch(m_config, config).toMap();
+
     m_config = config;
     syncConfigToCache();
     emit configChanged();
-    writeConfig();
+    schedulePatchWrite(changes, false);
+}
+
+bool Config::patchConfig(const QVariantMap &patch) {
+    m_error.clear();
+    syncCacheToConfig();
+
+    // merge and validate each patched top level section on its own
+    QVariantMap patched;
+    QVariantMap changes;
+    for (QVariantMap::const_iterator i = patch.cbegin(); i != patch.cend(); ++i) {
+        QVariant section = ConfigUtil::mergePatch(m_config.value(i.key()), i.value());
+        if (section == m_config.value(i.key())) {
+            continue;
+        }
+        if (!m_jsf->validateProperty(i.key(), QJsonValue::fromVariant(section), m_error)) {
+            qCWarning(CLASS_LC) << "Config patch of" << i.key() << "failed schema validation:" << m_error;
+            return false;
+        }
+        patched.insert(i.key(), section);
+        changes.insert(i.key(), i.value());
+    }
+
+    if (patched.isEmpty()) {
+        return true;
+    }
+
+    QString     oldProfileId = m_cacheProfileId;
+    QVariantMap oldUIConfig  = m_cacheUIConfig;
+    QVariantMap oldProfiles  = m_cacheUIProfiles;
+    QVariantMap oldPages     = m_cacheUIPages;
+    QVariantMap oldGroups    = m_cacheUIGroups;
+    QStringList oldFavorites = profileFavorites();
+
+    for (QVariantMap::const_iterator i = patched.cbegin(); i != patched.cend(); ++i) {
+        if (i.value().isNull()) {
+            m_config.remove(i.key());
+        } else {
+            m_config.insert(i.key(), i.value());
+        }
+    }
+    syncConfigToCache();
+
+    schedulePatchWrite(changes, false);
+
+    if (patched.contains("entities") || patched.contains("integrations")) {
+        emit configChanged();
+    }
+    if (patched.contains("settings")) {
+        emit settingsChanged();
+    }
+    if (patched.contains("ui_config")) {
+        if (m_cacheProfileId != oldProfileId) {
+            emit profileIdChanged();
+        }
+        if (m_cacheUIProfiles != oldProfiles) {
+            emit profilesChanged();
+        }
+        if (m_cacheUIPages != oldPages) {
+            emit pagesChanged();
+        }
+        if (m_cacheUIGroups != oldGroups) {
+            emit groupsChanged();
+        }
+        if (profileFavorites() != oldFavorites) {
+            emit profileFavoritesChanged();
+        }
+        if (m_cacheUIConfig != oldUIConfig) {
+            emit uiConfigChanged();
+        }
+    }
+
+    return true;
 }
 
 bool Config::readConfig(const QString &filePath) {
@@ -98,60 +203,177 @@ bool Config::readConfig(const QString &filePath) {
     m_jsf->setName(filePath);
     m_config = m_jsf->read().toMap();
     m_error  = m_jsf->error();
+
+    // recover changes which were not yet written when the application stopped
+    bool replayed = replayJournal();
+
     syncConfigToCache();
     emit configChanged();
 
-    return m_jsf->isValid();
+    if (replayed) {
+        // write a new checkpoint, this also removes the journal
+        writeConfig(false);
+    }
+
+    return m_error.isEmpty();
+}
+
+bool Config::replayJournal() {
+    QFile journal(ConfigWriter::journalFileName(m_jsf->name()));
+    if (!journal.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    // apply the entries in order and keep the valid prefix, later entries build on the rejected one
+    QVariantMap config    = m_config;
+    int         entries   = 0;
+    bool        discarded = false;
+    while (!journal.atEnd()) {
+        QJsonParseError error;
+        QJsonDocument   doc = QJsonDocument::fromJson(journal.readLine(), &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            // the last entry might be incomplete after a power loss
+            qCWarning(CLASS_LC) << "Ignoring invalid config journal entry" << entries + 1 << error.errorString();
+            discarded = true;
+            break;
+        }
+
+        QVariantMap patched = ConfigUtil::mergePatch(config, doc.object().toVariantMap()).toMap();
+        QString     validationError;
+        if (!m_jsf->validate(QJsonDocument::fromVariant(patched), validationError)) {
+            qCWarning(CLASS_LC) << "Discarding config journal entry" << entries + 1
+                                << "and the following ones, schema validation failed:" << validationError;
+            discarded = true;
+            break;
+        }
+        config = patched;
+        entries++;
+    }
+    journal.close();
+
+    if (entries == 0) {
+        if (discarded) {
+            // nothing to recover, make sure that new entries are not appended after the invalid one
+            journal.remove();
+        }
+        return false;
+    }
+
+    qCInfo(CLASS_LC) << "Replayed" << entries << "config journal entries";
+    m_config = config;
+    m_error.clear();
+    return true;
 }
 
-bool Config::writeConfig() {
+bool Config::writeConfig(bool validate) {
     syncCacheToConfig();
-    bool result = m_jsf->write(m_config);
-    m_error     = m_jsf->error();
-    qCCritical(CLASS_LC()) << "Write to config file success:" << result;
+    m_writeTimer->stop();
+    validate |= m_writeValidate;
+    m_writeValidate = false;
+
+    // the GUI thread is blocked while the writer thread accesses the members
+    bool result = false;
+    QMetaObject::invokeMethod(m_writer,
+                              [&]() {
+                                  result       = m_writer->write(m_jsf->name(), m_config, validate);
+                                  m_writeError = m_writer->error();
+                              },
+                              Qt::BlockingQueuedConnection);
     return result;
 }
 
+bool Config::flush() {
+    if (!m_writeTimer->isActive()) {
+        // wait for a write which might still be in progress on the writer thread and take its result directly,
+        // its onWriteDone might not have been delivered yet
+        bool result = false;
+        QMetaObject::invokeMethod(m_writer,
+                                  [&]() {
+                                      m_writeError = m_writer->error();
+                                      result       = m_writeError.isEmpty();
+                                  },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+    qCDebug(CLASS_LC) << "Flushing pending config changes";
+    return writeConfig(false);
+}
+
+void Config::scheduleWrite(const QStringList &sections, bool validate) {
+    // m_config still holds the state before the cached sections were changed
+    QVariantMap previous;
+    for (const QString &section : sections) {
+        previous.insert(section, m_config.value(section));
+    }
+    syncCacheToConfig();
+
+    QVariantMap changes;
+    for (const QString &section : sections) {
+        QVariant patch = ConfigUtil::createMergePatch(previous.value(section), m_config.value(section));
+        if (patch != QVariant(QVariantMap())) {
+            changes.insert(section, patch);
+        }
+    }
+    schedulePatchWrite(changes, validate);
+}
+
+void Config::schedulePatchWrite(const QVariantMap &changes, bool validate) {
+    if (!changes.isEmpty()) {
+        // journal the merge patch immediately, the complete config is only written after the write delay
+        QString filePath = m_jsf->name();
+        QMetaObject::invokeMethod(m_writer, [=]() { m_writer->appendJournal(filePath, changes); },
+                                  Qt::QueuedConnection);
+    }
+
+    m_writeValidate |= validate;
+    m_writeTimer->start();
+}
+
+void Config::onWriteTimeout() {
+    QString     filePath = m_jsf->name();
+    QVariantMap config   = m_config;
+    bool        validate = m_writeValidate;
+    m_writeValidate      = false;
+
+    QMetaObject::invokeMethod(m_writer, [=]() { m_writer->write(filePath, config, validate); }, Qt::QueuedConnection);
+}
+
+void Config::onWriteDone(bool success, const QString &error) {
+    // write errors are kept apart from m_error, which holds the result of the last validation
+    m_writeError = error;
+    if (!success) {
+        emit configWriteError(m_writeError);
+    }
+}
+
 void Config::setSettings(const QVariantMap &config) {
     m_cacheSettings = config;
-    if (!writeConfig()) {
-        // this is a Q_PROPERTY write method: can't return false!
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"settings"});
     emit settingsChanged();
 }
 
 void Config::setProfiles(const QVariantMap &config) {
     m_cacheUIProfiles = config;
     m_cacheUIProfile  = m_cacheUIProfiles[m_cacheProfileId].toMap();
-    if (writeConfig()) {
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"ui_config"});
     emit profilesChanged();
 }
 
 void Config::setUIConfig(const QVariantMap &config) {
     m_cacheUIConfig = config;
-    if (writeConfig()) {
-        // this is a Q_PROPERTY write method: can't return false!
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"ui_config"});
     emit uiConfigChanged();
 }
 
 void Config::setPages(const QVariantMap &config) {
     m_cacheUIPages = config;
-    if (writeConfig()) {
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"ui_config"});
     emit pagesChanged();
 }
 
 void Config::setGroups(const QVariantMap &config) {
     m_cacheUIGroups = config;
-    if (writeConfig()) {
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"ui_config"});
     emit groupsChanged();
 }
 
@@ -160,9 +382,7 @@ void Config::setUnitSystem(UnitSystem value) {
         m_cacheUnitSystem = value;
         emit unitSystemChanged();
     }
-    if (writeConfig()) {
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"settings"});
 }
 
 QObject *Config::getQMLObject(QList<QObject *> nodes, const QString &name) {
@@ -179,17 +399,34 @@ QObject *Config::getQMLObject(QList<QObject *> nodes, const QString &name) {
     return nullptr;
 }
 
-QObject *Config::getQMLObject(const QString &name) { return getQMLObject(m_engine->rootObjects(), name); }
+QObject *Config::getQMLObject(const QString &name) {
+    QObject *object = m_qmlObjects.value(name);
+    if (object == nullptr) {
+        object = getQMLObject(m_engine->rootObjects(), name);
+        registerQMLObject(name, object);
+    }
+    return object;
+}
+
+void Config::registerQMLObject(const QString &name, QObject *object) {
+    if (name.isEmpty() || object == nullptr || m_qmlObjects.value(name) == object) {
+        return;
+    }
+    m_qmlObjects.insert(name, object);
+    connect(object, &QObject::destroyed, this, [=]() {
+        // the entry is kept if another object registered with the same name in the meantime
+        if (m_qmlObjects.value(name).isNull()) {
+            m_qmlObjects.remove(name);
+        }
+    });
+}
 
 void Config::setProfileId(QString id) {
     qCDebug(CLASS_LC()) << "Profile id changing to:" << id << "from:" << m_cacheProfileId;
     m_cacheProfileId = id;
     m_cacheUIProfile = m_cacheUIProfiles[m_cacheProfileId].toMap();
 
-    if (!writeConfig()) {
-        // this is a Q_PROPERTY write method: can't return false!
-        emit configWriteError(m_error);
-    }
+    scheduleWrite({"ui_config"});
     emit profileIdChanged();
 }
 
@@ -218,3 +455,39 @@ void Config::syncCacheToConfig() {
     m_config.insert("settings", m_cacheSettings);
     m_config.insert("ui_config", m_cacheUIConfig);
 }
+
+ConfigWriter::ConfigWriter(const QString &schemaFilePath, QObject *parent) : QObject(parent) {
+    m_jsf = new JsonFile(this);
+    m_jsf->setSchemaPath(schemaFilePath);
+    m_jsf->setChecksumEnabled(true);
+}
+
+bool ConfigWriter::write(const QString &filePath, const QVariantMap &config, bool validate) {
+    m_jsf->setName(filePath);
+    bool result = m_jsf->write(config, validate);
+    qCDebug(CLASS_LC()) << "Write to config file success:" << result;
+    if (result) {
+        // the written config is the new checkpoint: all journaled changes are contained
+        QFile::remove(journalFileName(filePath));
+    }
+    emit writeDone(result, m_jsf->error());
+    return result;
+}
+
+void ConfigWriter::appendJournal(const QString &filePath, const QVariantMap &changes) {
+    QFile journal(journalFileName(filePath));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qCWarning(CLASS_LC) << "Cannot open config journal" << journal.fileName() << journal.errorString();
+        return;
+    }
+
+    QByteArray entry = QJsonDocument::fromVariant(changes).toJson(QJsonDocument::Compact);
+    entry.append('\n');
+    if (journal.write(entry) != entry.size() || !journal.flush()) {
+        qCWarning(CLASS_LC) << "Cannot write config journal" << journal.fileName() << journal.errorString();
+    }
+#ifdef Q_OS_LINUX
+    ::fsync(journal.handle());
+#endif
+    journal.close();
+}
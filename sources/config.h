@@ -23,14 +23,20 @@
 #pragma once
 
 #include <QJsonArray>
+#include <QHash>
 #include <QObject>
+#include <QPointer>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QThread>
+#include <QTimer>
 #include <QtDebug>
 
 #include "jsonfile.h"
 #include "yio-interface/configinterface.h"
 
+class ConfigWriter;
+
 class Config : public QObject, public ConfigInterface {
     Q_OBJECT
     Q_INTERFACES(ConfigInterface)
@@ -69,10 +75,22 @@ class Config : public QObject, public ConfigInterface {
     // error
     QString getError() const { return m_error; }
 
+    // error of the last configuration write, empty if it was successful
+    QString getWriteError() const { return m_writeError; }
+
     // config
     QVariantMap getConfig() override { return m_config; }
     void        setConfig(const QVariantMap& config) override;
 
+    /**
+     * @brief patchConfig Applies a JSON merge patch (RFC 7386) to the configuration.
+     * Only the changed top level sections are validated against the schema and only the signals of the changed
+     * sections are emitted.
+     * @param patch The merge patch. Null values remove the corresponding key.
+     * @return true if the patch was valid and the configuration is scheduled for writing
+     */
+    bool patchConfig(const QVariantMap& patch);
+
     // profile Id
     QString getProfileId() { return m_cacheProfileId; }
     void    setProfileId(QString id);
@@ -124,12 +142,33 @@ class Config : public QObject, public ConfigInterface {
 
     // read and write configuration to file
     bool readConfig(const QString& filePath);
-    bool writeConfig();
+
+    /**
+     * @brief writeConfig Writes the configuration to the file and waits until the write has finished.
+     * Pending delayed writes are cancelled since they are covered by this write.
+     * @param validate Validate the configuration against the schema before writing
+     * @return true if successful
+     */
+    bool writeConfig(bool validate = true);
+
+    /**
+     * @brief flush Writes pending configuration changes immediately. Must be called before shutdown or reboot.
+     * @return true if there was nothing to write or the write was successful
+     */
+    Q_INVOKABLE bool flush();
 
     // get a QML object, you need to have objectName property of the QML object set to be able to use this
     QObject* getQMLObject(QList<QObject*> nodes, const QString& name);
+    // registered objects are returned from the registry, others are searched once in the object tree and registered
     QObject* getQMLObject(const QString& name) override;
 
+    /**
+     * @brief registerQMLObject Registers a QML object for getQMLObject. The object is removed from the registry when it
+     * is destroyed. QML objects register themselves with: Component.onCompleted: config.registerQMLObject(objectName,
+     * this)
+     */
+    Q_INVOKABLE void registerQMLObject(const QString& name, QObject* object);
+
     // get all integrations and entities
     QVariantMap getAllIntegrations() override { return m_config["integrations"].toMap(); }
     QVariantMap getIntegration(const QString& type) override { return getAllIntegrations().value(type).toMap(); }
@@ -159,17 +198,51 @@ class Config : public QObject, public ConfigInterface {
     void syncConfigToCache();
     void syncCacheToConfig();
 
+    /**
+     * @brief schedulePatchWrite Schedules a delayed write of the configuration on the writer thread.
+     * Multiple changes within the write delay are coalesced into one write. The merge patch of the change is appended
+     * to the journal right away, so it can be recovered at startup if the application stops before the write.
+     * @param changes The merge patch (RFC 7386) of the change, relative to the previously scheduled state
+     * @param validate Validate the configuration against the schema before writing
+     */
+    void schedulePatchWrite(const QVariantMap& changes, bool validate = true);
+
+    /**
+     * @brief scheduleWrite Syncs the caches of the given sections to the configuration and schedules a write of the
+     * differences.
+     */
+    void scheduleWrite(const QStringList& sections, bool validate = true);
+    void onWriteTimeout();
+    void onWriteDone(bool success, const QString& error);
+
+    /**
+     * @brief replayJournal Applies the journaled changes to the configuration read from the config file.
+     * Each entry is validated when it is applied, replaying stops at the first invalid entry.
+     * @return true if changes were replayed and the configuration needs to be written
+     */
+    bool replayJournal();
+
     static Config*         s_instance;
     QQmlApplicationEngine* m_engine;
 
+    QHash<QString, QPointer<QObject>> m_qmlObjects;  // QML object registry, objectName -> object
+
     QVariantMap  m_config;
     QVariantList m_languages;
 
     JsonFile* m_jsf;
     QString   m_error;
+    QString   m_writeError;
 
     JsonFile* m_tf;
 
+    // Write-behind persistence
+    static const int WRITE_DELAY = 500;  // ms to wait for further changes before writing the configuration
+    QThread          m_writerThread;
+    ConfigWriter*    m_writer;
+    QTimer*          m_writeTimer;
+    bool             m_writeValidate = false;
+
     // Caches to improve performance
     QString     m_cacheProfileId;
     QVariantMap m_cacheSettings;
@@ -182,3 +255,27 @@ class Config : public QObject, public ConfigInterface {
 };
 
 typedef Config::UnitSystem UnitSystem;
+
+/**
+ * @brief The ConfigWriter class serializes and writes the configuration and the change journal on a worker thread.
+ */
+class ConfigWriter : public QObject {
+    Q_OBJECT
+
+ public:
+    explicit ConfigWriter(const QString& schemaFilePath, QObject* parent = nullptr);
+
+    QString error() const { return m_jsf->error(); }
+
+    static QString journalFileName(const QString& configFilePath) { return configFilePath + ".journal"; }
+
+ signals:
+    void writeDone(bool success, const QString& error);
+
+ public slots:  // NOLINT open issue: https://github.com/cpplint/cpplint/pull/99
+    bool write(const QString& filePath, const QVariantMap& config, bool validate);
+    void appendJournal(const QString& filePath, const QVariantMap& changes);
+
+ private:
+    JsonFile* m_jsf;
+};
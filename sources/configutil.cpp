@@ -69,3 +69,48 @@ QVariant ConfigUtil::getValue(QJsonObject const& settings, QString const& path,
 
     return defaultValue;
 }
+
+QVariant ConfigUtil::mergePatch(QVariant const &target, QVariant const &patch) {
+    if (patch.type() != QVariant::Map) {
+        return patch;
+    }
+
+    QVariantMap result   = target.type() == QVariant::Map ? target.toMap() : QVariantMap();
+    QVariantMap patchMap = patch.toMap();
+
+    for (QVariantMap::const_iterator iter = patchMap.begin(); iter != patchMap.end(); ++iter) {
+        if (iter.value().isNull()) {
+            result.remove(iter.key());
+        } else {
+            result.insert(iter.key(), mergePatch(result.value(iter.key()), iter.value()));
+        }
+    }
+
+    return result;
+}
+
+QVariant ConfigUtil::createMergePatch(QVariant const &source, QVariant const &target) {
+    if (source.type() != QVariant::Map || target.type() != QVariant::Map) {
+        return source == target ? QVariant(QVariantMap()) : target;
+    }
+
+    QVariantMap sourceMap = source.toMap();
+    QVariantMap targetMap = target.toMap();
+    QVariantMap result;
+
+    for (QVariantMap::const_iterator iter = sourceMap.begin(); iter != sourceMap.end(); ++iter) {
+        if (!targetMap.contains(iter.key())) {
+            result.insert(iter.key(), QVariant());
+        }
+    }
+    for (QVariantMap::const_iterator iter = targetMap.begin(); iter != targetMap.end(); ++iter) {
+        QVariant value = sourceMap.value(iter.key());
+        if (!sourceMap.contains(iter.key())) {
+            result.insert(iter.key(), iter.value());
+        } else if (value != iter.value()) {
+            result.insert(iter.key(), createMergePatch(value, iter.value()));
+        }
+    }
+
+    return result;
+}
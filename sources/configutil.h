@@ -59,4 +59,24 @@ class ConfigUtil {
      */
     static QVariant getValue(QJsonObject const& settings, QString const& path,
                              QVariant const& defaultValue = QVariant());
+
+    /**
+     * @brief Applies a JSON merge patch (RFC 7386) to the given value
+     * @details Objects in the patch are merged recursively, null values remove the key and all other values replace
+     * the target value.
+     * @param target Value to patch
+     * @param patch Merge patch
+     * @return The patched value
+     */
+    static QVariant mergePatch(QVariant const& target, QVariant const& patch);
+
+    /**
+     * @brief Creates the JSON merge patch (RFC 7386) which turns source into target
+     * @details Only changed keys of objects are contained, all other values including arrays are replaced as a whole.
+     * mergePatch(source, createMergePatch(source, target)) returns target.
+     * @param source Original value
+     * @param target Changed value
+     * @return The merge patch, an empty map if both values are equal
+     */
+    static QVariant createMergePatch(QVariant const& source, QVariant const& target);
 };
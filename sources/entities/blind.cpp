@@ -28,7 +28,7 @@ BlindInterface::~BlindInterface() {}
 
 QString Blind::Type = "blind";
 
-bool Blind::updateAttrByIndex(int attrIndex, const QVariant& value) {
+bool Blind::updateAttribute(int attrIndex, const QVariant& value) {
     bool chg = false;
     switch (attrIndex) {
         case BlindDef::STATE:
@@ -41,7 +41,7 @@ bool Blind::updateAttrByIndex(int attrIndex, const QVariant& value) {
             if (m_position != value.toInt()) {
                 m_position = value.toInt();
                 chg        = true;
-                emit positionChanged();
+                notifyChange(&Blind::positionChanged);
             }
             break;
     }
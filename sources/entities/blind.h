@@ -45,7 +45,7 @@ class Blind : public Entity, BlindInterface {
     Q_INVOKABLE void stop();
     Q_INVOKABLE void setPosition(int value);
 
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
 
     void turnOn() override { open(); }
     void turnOff() override { close(); }
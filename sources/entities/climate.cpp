@@ -34,7 +34,7 @@ void Climate::heat() { command(ClimateDef::C_HEAT, ""); }
 
 void Climate::cool() { command(ClimateDef::C_COOL, ""); }
 
-bool Climate::updateAttrByIndex(int attrIndex, const QVariant &value) {
+bool Climate::updateAttribute(int attrIndex, const QVariant &value) {
     bool chg = false;
     switch (attrIndex) {
         case ClimateDef::STATE:
@@ -47,35 +47,35 @@ bool Climate::updateAttrByIndex(int attrIndex, const QVariant &value) {
             if (m_temperature != value.toDouble()) {
                 m_temperature = value.toDouble();
                 chg           = true;
-                emit temperatureChanged();
+                notifyChange(&Climate::temperatureChanged);
             }
             break;
         case ClimateDef::TARGET_TEMPERATURE:
             if (m_targetTemperature != value.toDouble()) {
                 m_targetTemperature = value.toDouble();
                 chg                 = true;
-                emit targetTemperatureChanged();
+                notifyChange(&Climate::targetTemperatureChanged);
             }
             break;
         case ClimateDef::TEMPERATURE_UNIT:
             if (m_temperatureUnit != value.toString()) {
                 m_temperatureUnit = value.toString();
                 chg               = true;
-                emit temperatureUnitChanged();
+                notifyChange(&Climate::temperatureUnitChanged);
             }
             break;
         case ClimateDef::TEMPERATURE_MAX:
             if (m_temperatureMax != value.toDouble()) {
                 m_temperatureMax = value.toDouble();
                 chg              = true;
-                emit temperatureMaxChanged();
+                notifyChange(&Climate::temperatureMaxChanged);
             }
             break;
         case ClimateDef::TEMPERATURE_MIN:
             if (m_temperatureMin != value.toDouble()) {
                 m_temperatureMin = value.toDouble();
                 chg              = true;
-                emit temperatureMinChanged();
+                notifyChange(&Climate::temperatureMinChanged);
             }
             break;
     }
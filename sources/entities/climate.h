@@ -48,7 +48,7 @@ class Climate : public Entity, ClimateInterface {
     Q_INVOKABLE void cool();
 
     // overrides from Entity class
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
 
     void turnOn() override;
     void turnOff() override;
@@ -24,6 +24,9 @@
 
 #include <QJsonArray>
 #include <QLoggingCategory>
+#include <QReadLocker>
+#include <QThread>
+#include <QWriteLocker>
 #include <QTimer>
 #include <QtDebug>
 
@@ -60,83 +63,160 @@ QList<QObject *> Entities::list() {
     // This is ued in rare cases (until now not at all).
     // Overhead of creating this QList is justified compared to the advantage dealing with Entity* instead of QObject*
     QList<QObject *> entities;
-    for (QMap<QString, Entity *>::iterator i = m_entities.begin(); i != m_entities.end(); ++i) {
-        entities.append(i.value());
-    }
+    runOnGuiThread([&]() {
+        materialize(QString(), QString());
+
+        QStringList entityIds = m_entities.keys();
+        // sorted by entity_id for a stable order
+        entityIds.sort();
+        for (const QString &entityId : entityIds) {
+            entities.append(m_entities.value(entityId));
+        }
+    });
     return entities;
 }
 
 void Entities::load() {
     QVariantMap entities = Config::getInstance()->getAllEntities();
 
+    // only the records are kept, creating all entity objects up front dominated the startup time
     for (int i = 0; i < m_supportedEntities.length(); i++) {
         if (entities.contains(m_supportedEntities[i])) {
-            QVariantList type = entities.value(m_supportedEntities[i]).toJsonArray().toVariantList();
-
-            for (int k = 0; k < type.length(); k++) {
-                QVariantMap           map = type[k].toMap();
-                QObject *             obj = Integrations::getInstance()->get(map.value("integration").toString());
-                IntegrationInterface *integration = qobject_cast<IntegrationInterface *>(obj);
-                add(m_supportedEntities[i], map, integration);
+            const QVariantList type = entities.value(m_supportedEntities[i]).toList();
+
+            for (const QVariant &entity : type) {
+                QVariantMap map      = entity.toMap();
+                QString     entityId = map.value("entity_id").toString();
+                if (!m_entities.contains(entityId)) {
+                    QWriteLocker locker(&m_lock);
+                    m_records.insert(entityId, {m_supportedEntities[i], map});
+                }
             }
         }
     }
     emit entitiesLoaded();
 
     // when all entities are loaded, connect the integrations
-    QList<QObject *> integrations = Integrations::getInstance()->list();
-    for (int i = 0; i < integrations.count(); i++) {
-        QObject *             obj = integrations[i];
-        IntegrationInterface *ii  = qobject_cast<IntegrationInterface *>(obj);
-        ii->connect();
-    }
+    Integrations::getInstance()->scheduler()->invokeAll(&IntegrationInterface::connect);
 }
 
-QList<EntityInterface *> Entities::getByType(const QString &type) {
+QList<EntityInterface *> Entities::toInterfaceList(const QList<Entity *> &entities) {
     QList<EntityInterface *> e;
-    for (QObject *value : m_entities) {
-        if (value->property("type") == type) {
-            e.append(qobject_cast<EntityInterface *>(m_entities.value(value->property("entity_id").toString())));
+    e.reserve(entities.size());
+    for (Entity *entity : entities) {
+        e.append(entity->entityInterface());
+    }
+    return e;
+}
+
+Entity *Entities::materialize(const QString &entity_id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+    Entity *entity = m_entities.value(entity_id);
+    if (entity == nullptr && m_records.contains(entity_id)) {
+        EntityRecord record;
+        {
+            QWriteLocker locker(&m_lock);
+            record = m_records.take(entity_id);
+        }
+        QObject *             obj = Integrations::getInstance()->get(record.config.value("integration").toString());
+        IntegrationInterface *integration = qobject_cast<IntegrationInterface *>(obj);
+        add(record.type, record.config, integration);
+        entity = m_entities.value(entity_id);
+    }
+    return entity;
+}
+
+void Entities::materialize(const QString &key, const QString &value) {
+    Q_ASSERT(QThread::currentThread() == thread());
+    QStringList entityIds;
+    for (auto record = m_records.cbegin(); record != m_records.cend(); ++record) {
+        if (key.isEmpty() || (key == "type" ? record->type : record->config.value(key).toString()) == value) {
+            entityIds.append(record.key());
+        }
+    }
+    for (const QString &entityId : entityIds) {
+        materialize(entityId);
+    }
+}
+
+Entity *Entities::find(const QString &entity_id) {
+    if (QThread::currentThread() == thread()) {
+        return materialize(entity_id);
+    }
+    {
+        QReadLocker locker(&m_lock);
+        Entity *    entity = m_entities.value(entity_id);
+        if (entity != nullptr || !m_records.contains(entity_id)) {
+            return entity;
         }
     }
+    Entity *entity = nullptr;
+    runOnGuiThread([&]() { entity = materialize(entity_id); });
+    return entity;
+}
+
+void Entities::runOnGuiThread(const std::function<void()> &function) {
+    if (QThread::currentThread() == thread()) {
+        function();
+    } else {
+        QMetaObject::invokeMethod(this, function, Qt::BlockingQueuedConnection);
+    }
+}
+
+QList<EntityInterface *> Entities::getByType(const QString &type) {
+    QList<EntityInterface *> e;
+    runOnGuiThread([&]() {
+        materialize("type", type);
+        e = toInterfaceList(m_entitiesByType.value(type));
+    });
     return e;
 }
 
 // TODO(marton) this function might be removed
 QList<EntityInterface *> Entities::getByArea(const QString &area) {
     QList<EntityInterface *> e;
-    for (QMap<QString, Entity *>::iterator i = m_entities.begin(); i != m_entities.end(); ++i) {
-        if (i.value()->area() == area) {
-            e.append(qobject_cast<EntityInterface *>(i.value()));
-        }
-    }
+    runOnGuiThread([&]() {
+        materialize("area", area);
+        e = toInterfaceList(m_entitiesByArea.value(area));
+    });
     return e;
 }
 
 QList<EntityInterface *> Entities::getByAreaType(const QString &area, const QString &type) {
     QList<EntityInterface *> e;
-    for (QMap<QString, Entity *>::iterator i = m_entities.begin(); i != m_entities.end(); ++i) {
-        if (i.value()->area() == area && i.value()->type() == type) {
-            e.append(qobject_cast<EntityInterface *>(i.value()));
+    runOnGuiThread([&]() {
+        materialize("area", area);
+        for (Entity *entity : m_entitiesByArea.value(area)) {
+            if (entity->type() == type) {
+                e.append(entity->entityInterface());
+            }
         }
-    }
+    });
     return e;
 }
 
 QList<EntityInterface *> Entities::getByIntegration(const QString &integration) {
     QList<EntityInterface *> e;
-    for (QMap<QString, Entity *>::iterator i = m_entities.begin(); i != m_entities.end(); ++i) {
-        if (i.value()->integration() == integration) {
-            e.append(qobject_cast<EntityInterface *>(i.value()));
-        }
-    }
+    runOnGuiThread([&]() {
+        materialize(Config::KEY_INTEGRATION, integration);
+        e = toInterfaceList(m_entitiesByIntegration.value(integration));
+    });
     return e;
 }
+
 void Entities::setConnected(const QString &integrationId, bool connected) {
-    for (QMap<QString, Entity *>::iterator i = m_entities.begin(); i != m_entities.end(); ++i) {
-        if (i.value()->integration() == integrationId) {
-            i.value()->setConnected(connected);
-        }
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [=]() { setConnected(integrationId, connected); }, Qt::QueuedConnection);
+        return;
+    }
+    // entities created later take the state from here
+    if (connected) {
+        m_connectedIntegrations.insert(integrationId);
+    } else {
+        m_connectedIntegrations.remove(integrationId);
+    }
+    for (Entity *entity : m_entitiesByIntegration.value(integrationId)) {
+        entity->setConnected(connected);
     }
 }
 
@@ -153,14 +233,17 @@ bool Entities::isSupportedEntityType(const QString &type) {
     //    }
 }
 
-QObject *Entities::get(const QString &entity_id) { return m_entities.value(entity_id); }
+QObject *Entities::get(const QString &entity_id) { return find(entity_id); }
 
 EntityInterface *Entities::getEntityInterface(const QString &entity_id) {
-    return qobject_cast<EntityInterface *>(m_entities.value(entity_id));
+    Entity *entity = find(entity_id);
+    return entity ? entity->entityInterface() : nullptr;
 }
 
 /// ADD NEW ENTITY TYPE HERE
 void Entities::add(const QString &type, const QVariantMap &config, IntegrationInterface *integrationObj) {
+    // the entities are children of this object and must be created on its thread
+    Q_ASSERT(QThread::currentThread() == thread());
     Entity *entity = nullptr;
     // Light entity
     if (type == "light") {
@@ -188,20 +271,54 @@ void Entities::add(const QString &type, const QVariantMap &config, IntegrationIn
     if (entity == nullptr) {
         qCDebug(CLASS_LC) << "Illegal entity type : " << type;
     } else {
-        m_entities.insert(entity->entity_id(), entity);
+        {
+            QWriteLocker locker(&m_lock);
+            m_entities.insert(entity->entity_id(), entity);
+            m_entitiesByType[entity->type()].append(entity);
+            m_entitiesByArea[entity->area()].append(entity);
+            m_entitiesByIntegration[entity->integration()].append(entity);
+        }
+        entity->setBatchUpdates(m_batchUpdates);
+        entity->setConnected(m_connectedIntegrations.contains(entity->integration()));
+        connect(entity, &Entity::attributeChanged, this, [=](int attrIndex) { emit entityChanged(entity, attrIndex); });
     }
 }
 
-void Entities::remove(const QString &entity_id) { m_entities.remove(entity_id); }
+void Entities::remove(const QString &entity_id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+    QWriteLocker locker(&m_lock);
+    m_records.remove(entity_id);
+    Entity *entity = m_entities.take(entity_id);
+    if (entity) {
+        m_entitiesByType[entity->type()].removeOne(entity);
+        m_entitiesByArea[entity->area()].removeOne(entity);
+        m_entitiesByIntegration[entity->integration()].removeOne(entity);
+    }
+}
 
 void Entities::update(const QString &entity_id, const QVariantMap &attributes) {
-    Entity *e = static_cast<Entity *>(m_entities.value(entity_id));
+    if (QThread::currentThread() != thread()) {
+        // integrations running on their own thread, see IntegrationScheduler
+        QMetaObject::invokeMethod(this, [=]() { update(entity_id, attributes); }, Qt::QueuedConnection);
+        return;
+    }
+    Entity *e = materialize(entity_id);
     if (e == nullptr)
         qCDebug(CLASS_LC) << "Entity not found : " << entity_id;
     else
         e->update(attributes);
 }
 
+void Entities::setBatchUpdates(bool value) {
+    if (m_batchUpdates != value) {
+        m_batchUpdates = value;
+        for (Entity *entity : m_entities) {
+            entity->setBatchUpdates(value);
+        }
+        emit batchUpdatesChanged();
+    }
+}
+
 QList<QObject *> Entities::mediaplayersPlaying() { return m_mediaplayersPlaying.values(); }
 
 void Entities::addMediaplayersPlaying(const QString &entity_id) {
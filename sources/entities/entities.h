@@ -22,15 +22,20 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
 #include <QQmlComponent>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QString>
 #include <QTimer>
 #include <QVariant>
 
+#include <functional>
+
 #include "entities_supported.h"
 #include "entity.h"
 #include "yio-interface/entities/entitiesinterface.h"
@@ -47,11 +52,15 @@ class Entities : public QObject, public EntitiesInterface {
 
     Q_PROPERTY(QList<QObject*> mediaplayersPlaying READ mediaplayersPlaying NOTIFY mediaplayersPlayingChanged)
 
+    // batch update mode of all entities, see Entity::batchUpdates
+    Q_PROPERTY(bool batchUpdates READ batchUpdates WRITE setBatchUpdates NOTIFY batchUpdatesChanged)
+
  public:
     // get all entities
     QList<QObject*> list();
 
-    // load all entites from config file
+    // load all entites from config file, the entity objects are created on first access. Integrations on worker
+    // threads get them created on the GUI thread.
     Q_INVOKABLE void load();
 
     // get entity by entity_id
@@ -95,6 +104,9 @@ class Entities : public QObject, public EntitiesInterface {
 
     Q_INVOKABLE QString getSupportedEntityTranslation(const QString& type);
 
+    bool batchUpdates() { return m_batchUpdates; }
+    void setBatchUpdates(bool value);
+
     explicit Entities(QObject* parent = nullptr);
     ~Entities() override;
 
@@ -103,9 +115,44 @@ class Entities : public QObject, public EntitiesInterface {
  signals:
     void mediaplayersPlayingChanged();
     void entitiesLoaded();
+    void batchUpdatesChanged();
+    void entityChanged(Entity* entity, int attrIndex);  // an attribute of an entity has changed
 
  private:
-    QMap<QString, Entity*> m_entities;
+    // configured entity, the entity object is created on first access
+    struct EntityRecord {
+        QString     type;
+        QVariantMap config;
+    };
+
+    // creates the entity of a record, returns the existing entity if it was already created. GUI thread only.
+    Entity* materialize(const QString& entity_id);
+
+    // creates the entities of all records with the given value of the config key ("type" for the entity type).
+    // GUI thread only.
+    void materialize(const QString& key, const QString& value);
+
+    // entity lookup from any thread, entities which are not created yet are created on the GUI thread
+    Entity* find(const QString& entity_id);
+
+    // calls the function on the GUI thread, from other threads the caller waits until it has finished
+    void runOnGuiThread(const std::function<void()>& function);
+
+    // Guards the records and the entity registry. They are only modified on the GUI thread with the write lock
+    // held, so only lookups from other threads need the read lock.
+    QReadWriteLock m_lock;
+
+    // records of entities which are not created yet
+    QHash<QString, EntityRecord> m_records;
+    QSet<QString>                m_connectedIntegrations;
+
+    // entity registry: entity_id -> entity, with secondary indexes maintained in add() and remove()
+    QHash<QString, Entity*>        m_entities;
+    QHash<QString, QList<Entity*>> m_entitiesByType;
+    QHash<QString, QList<Entity*>> m_entitiesByArea;
+    QHash<QString, QList<Entity*>> m_entitiesByIntegration;
+
+    static QList<EntityInterface*> toInterfaceList(const QList<Entity*>& entities);
     QStringList            m_supportedEntities;
     QStringList            m_supportedEntitiesTranslation = {tr("Light"),  tr("Blind"),   tr("Media"),
                                                   tr("Remote"), tr("Climate"), tr("Switch")};
@@ -117,6 +164,8 @@ class Entities : public QObject, public EntitiesInterface {
 
     QMutex m_mutex;
 
+    bool m_batchUpdates = false;
+
  protected:
     QMetaEnum* m_enumSupportedEntityTypes;
 };
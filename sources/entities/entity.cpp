@@ -22,9 +22,15 @@
 
 #include "entity.h"
 
+#include <QHash>
+#include <QMetaProperty>
+#include <QThread>
 #include <QTimer>
 
+#include <algorithm>
+
 #include "../config.h"
+#include "../integrations/integrations.h"
 
 EntityInterface::~EntityInterface() {}
 
@@ -42,9 +48,14 @@ Entity::Entity(const QString& type, const QVariantMap& config, IntegrationInterf
       m_enumAttr(nullptr),
       m_enumFeatures(nullptr),
       m_enumCommands(nullptr),
-      m_specificInterface(nullptr) {
-    memset(m_supported_features, 0, sizeof(m_supported_features));
-
+      m_stateNames(nullptr),
+      m_attrNames(nullptr),
+      m_featureNames(nullptr),
+      m_commandNames(nullptr),
+      m_specificInterface(nullptr),
+      m_batchUpdates(false),
+      m_pendingChanges(0),
+      m_collectSignals(false) {
     QString entityId = config.value("entity_id").toString();
     setObjectName(entityId);
 
@@ -55,11 +66,26 @@ Entity::Entity(const QString& type, const QVariantMap& config, IntegrationInterf
 Entity::~Entity() {}
 
 void Entity::command(int command, const QVariant& param) {
-    if (m_integrationObj)
-        m_integrationObj->sendCommand(m_type, entity_id(), command, param);
+    if (m_integrationObj == nullptr) {
+        return;
+    }
+    // the integration might run on its own thread, see IntegrationScheduler
+    QString type     = m_type;
+    QString entityId = entity_id();
+    bool    posted   = Integrations::getInstance()->scheduler()->post(
+        m_integration,
+        [=](IntegrationInterface* integration) { integration->sendCommand(type, entityId, command, param); });
+    if (!posted) {
+        m_integrationObj->sendCommand(m_type, entityId, command, param);
+    }
 }
 
 bool Entity::update(const QVariantMap& attributes) {
+    if (QThread::currentThread() != thread()) {
+        // integrations running on their own thread, see IntegrationScheduler
+        QMetaObject::invokeMethod(this, [=]() { update(attributes); }, Qt::QueuedConnection);
+        return false;
+    }
     bool chg = false;
     for (QVariantMap::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
         if (updateAttrByName(iter.key(), iter.value()))
@@ -76,17 +102,16 @@ QString Entity::getAttrName(int attrIndex) {
     return m_enumAttr->valueToKey(attrIndex);
 }
 int Entity::getAttrIndex(const QString& attrName) {
-    Q_ASSERT(m_enumAttr != nullptr);
-    return m_enumAttr->keyToValue(attrName.toUpper().toUtf8());
+    Q_ASSERT(m_attrNames != nullptr);
+    return m_attrNames ? m_attrNames->value(attrName) : -1;
 }
 QString Entity::getFeatureName(int featureIndex) {
     Q_ASSERT(m_enumFeatures != nullptr);
     return QString(m_enumFeatures->valueToKey(featureIndex)).mid(2);
 }
 int Entity::getFeatureIndex(const QString& featureName) {
-    Q_ASSERT(m_enumFeatures != nullptr);
-    QString name = featureName;
-    return m_enumFeatures->keyToValue(name.prepend("F_").toUpper().toUtf8());
+    Q_ASSERT(m_featureNames != nullptr);
+    return m_featureNames ? m_featureNames->value(featureName) : -1;
 }
 
 QString Entity::getCommandName(int commandIndex) {
@@ -94,64 +119,41 @@ QString Entity::getCommandName(int commandIndex) {
     return QString(m_enumCommands->valueToKey(commandIndex)).mid(2);
 }
 int Entity::getCommandIndex(const QString& commandName) {
-    Q_ASSERT(m_enumCommands != nullptr);
-    QString name = commandName;
-    return m_enumCommands->keyToValue(name.prepend("C_").toUpper().toUtf8());
+    Q_ASSERT(m_commandNames != nullptr);
+    return m_commandNames ? m_commandNames->value(commandName) : -1;
 }
 
+// the name lists are shared by all entities of a type
 QStringList Entity::allAttributes() {
-    Q_ASSERT(m_enumAttr != nullptr);
-    QStringList list;
-    for (int i = 0; i < m_enumAttr->keyCount(); i++) list.append(m_enumAttr->key(i));
-    return list;
+    Q_ASSERT(m_attrNames != nullptr);
+    return m_attrNames->names();
 }
 QStringList Entity::allCommands() {
-    Q_ASSERT(m_enumAttr != nullptr);
-    QStringList list;
-    for (int i = 0; i < m_enumCommands->keyCount(); i++) {
-        QString name(m_enumCommands->key(i));
-        list.append(name.mid(2));
-    }
-    return list;
+    Q_ASSERT(m_commandNames != nullptr);
+    return m_commandNames->names();
 }
 bool Entity::isSupported(int feature) {
-    int byte = feature / 8;
-    int bit  = feature % 8;
-    Q_ASSERT(byte < static_cast<int>(sizeof(m_supported_features)));
-    return !!(m_supported_features[byte] & (1 << bit));
+    Q_ASSERT(feature < MAX_FEATURES);
+    return feature >= 0 && feature < MAX_FEATURES && m_supportedFeatures.test(static_cast<size_t>(feature));
 }
 
-QStringList Entity::supported_features() {
-    QStringList list;
-    for (int i = 0; i < MAX_FEATURES; i++) {
-        if (isSupported(i))
-            list.append(getFeatureName(i));
-    }
-    return list;
-}
+QStringList Entity::supported_features() { return m_supportedFeatureNames; }
 
 QStringList Entity::allFeatures() {
-    Q_ASSERT(m_enumAttr != nullptr);
-    QStringList list;
-    for (int i = 0; i < m_enumFeatures->keyCount(); i++) {
-        QString name(m_enumFeatures->key(i));
-        list.append(name.mid(2));
-    }
-    return list;
+    Q_ASSERT(m_featureNames != nullptr);
+    return m_featureNames->names();
 }
 QStringList Entity::allStates() {
-    Q_ASSERT(m_enumState != nullptr);
-    QStringList list;
-    for (int i = 0; i < m_enumState->keyCount(); i++) list.append(m_enumState->key(i));
-    return list;
+    Q_ASSERT(m_stateNames != nullptr);
+    return m_stateNames->names();
 }
 
 bool Entity::setState(int state) {
     if (m_state != state) {
         m_state = state;
-        emit stateChanged();
-        emit onChanged();
-        emit stateTextChanged();
+        notifyChange(&Entity::stateChanged);
+        notifyChange(&Entity::onChanged);
+        notifyChange(&Entity::stateTextChanged);
         return true;
     }
     return false;
@@ -161,11 +163,133 @@ QString Entity::stateText() {
     return m_enumState->valueToKey(m_state);
 }
 bool Entity::setStateText(const QString& stateText) {
-    Q_ASSERT(m_enumState != nullptr);
-    return setState(m_enumState->keyToValue(stateText.toUpper().toUtf8()));
+    Q_ASSERT(m_stateNames != nullptr);
+    return setState(m_stateNames ? m_stateNames->value(stateText) : -1);
+}
+
+bool Entity::updateAttrByIndex(int attrIndex, const QVariant& value) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [=]() { updateAttrByIndex(attrIndex, value); }, Qt::QueuedConnection);
+        return false;
+    }
+    if (m_batchUpdates && attrIndex >= 0 && attrIndex < MAX_ATTRIBUTES) {
+        // the change signals of the specific entity are recorded by notifyChange and emitted in emitPendingChanges
+        bool scheduled   = m_pendingChanges != 0 || !m_pendingSignals.isEmpty();
+        bool collecting  = m_collectSignals;
+        m_collectSignals = true;
+        bool chg         = updateAttribute(attrIndex, value);
+        m_collectSignals = collecting;
+        if (chg) {
+            m_pendingChanges |= 1u << attrIndex;
+        }
+        if (!scheduled && (m_pendingChanges != 0 || !m_pendingSignals.isEmpty())) {
+            QMetaObject::invokeMethod(this, &Entity::emitPendingChanges, Qt::QueuedConnection);
+        }
+        return chg;
+    }
+
+    bool chg = updateAttribute(attrIndex, value);
+    if (chg) {
+        emit attributeChanged(attrIndex);
+        emit attributesChanged(attrIndex >= 0 && attrIndex < MAX_ATTRIBUTES ? 1 << attrIndex : 0);
+    }
+    return chg;
+}
+
+void Entity::setBatchUpdates(bool value) {
+    if (m_batchUpdates != value) {
+        m_batchUpdates = value;
+        if (!value) {
+            emitPendingChanges();
+        }
+        emit batchUpdatesChanged();
+    }
+}
+
+void Entity::deferSignal(int methodIndex) {
+    if (methodIndex >= 0 && !m_pendingSignals.contains(methodIndex)) {
+        m_pendingSignals.append(methodIndex);
+    }
+}
+
+void Entity::emitPendingChanges() {
+    quint32                 changes       = m_pendingChanges;
+    QVarLengthArray<int, 8> signalIndexes = m_pendingSignals;
+    m_pendingChanges                      = 0;
+    m_pendingSignals.clear();
+
+    // the recorded signals first, the generic attribute signals are emitted after the specific properties changed
+    for (int methodIndex : signalIndexes) {
+        metaObject()->method(methodIndex).invoke(this, Qt::DirectConnection);
+    }
+    if (changes == 0) {
+        return;
+    }
+    for (int attrIndex = 0; attrIndex < MAX_ATTRIBUTES; attrIndex++) {
+        if ((changes & (1u << attrIndex)) != 0) {
+            emit attributeChanged(attrIndex);
+        }
+    }
+    emit attributesChanged(static_cast<int>(changes));
+}
+
+QVariant Entity::getAttrValue(int attrIndex) {
+    Q_ASSERT(m_enumAttr != nullptr);
+    // the state is exposed with its name
+    if (attrIndex == m_enumAttr->keyToValue("STATE")) {
+        return stateText();
+    }
+
+    int propertyIndex = attrPropertyIndex(attrIndex);
+    return propertyIndex < 0 ? QVariant() : metaObject()->property(propertyIndex).read(this);
+}
+
+// Case insensitive comparison of a property name with an attribute name, underscores of the attribute are ignored
+static bool isAttrProperty(const char* property, const char* attrName) {
+    while (*property != 0) {
+        while (*attrName == '_') attrName++;
+        if (QChar::toUpper(static_cast<uint>(*property)) != QChar::toUpper(static_cast<uint>(*attrName))) {
+            return false;
+        }
+        property++;
+        attrName++;
+    }
+    return *attrName == 0;
+}
+
+int Entity::attrPropertyIndex(int attrIndex) {
+    Q_ASSERT(m_enumAttr != nullptr);
+    // attribute index -> property index, resolved once per entity type
+    static QHash<const QMetaObject*, QHash<int, int>> s_attrProperties;
+    const QMetaObject*                                meta = metaObject();
+    if (!s_attrProperties.contains(meta)) {
+        QHash<int, int> properties;
+        for (int i = 0; i < m_enumAttr->keyCount(); i++) {
+            for (int p = 0; p < meta->propertyCount(); p++) {
+                if (isAttrProperty(meta->property(p).name(), m_enumAttr->key(i))) {
+                    properties.insert(m_enumAttr->value(i), p);
+                    break;
+                }
+            }
+        }
+        s_attrProperties.insert(meta, properties);
+    }
+    return s_attrProperties.value(meta).value(attrIndex, -1);
 }
 
-bool Entity::updateAttrByIndex(int idx, const QVariant& value) {
+QVariantMap Entity::getAttributes() {
+    Q_ASSERT(m_enumAttr != nullptr);
+    QVariantMap attributes;
+    for (int i = 0; i < m_enumAttr->keyCount(); i++) {
+        QVariant value = getAttrValue(m_enumAttr->value(i));
+        if (value.isValid()) {
+            attributes.insert(QString(m_enumAttr->key(i)).toLower(), value);
+        }
+    }
+    return attributes;
+}
+
+bool Entity::updateAttribute(int idx, const QVariant& value) {
     Q_UNUSED(idx)
     Q_UNUSED(value)
     Q_ASSERT(false);  // Must be overriden in specific entity
@@ -194,6 +318,12 @@ void Entity::setFavorite(bool value) {
 }
 
 void Entity::initializeSupportedFeatures(const QVariantMap& config) {
+    // the enums are set by the concrete entity constructor before calling this method
+    m_stateNames   = nameIndex(m_enumState);
+    m_attrNames    = nameIndex(m_enumAttr);
+    m_featureNames = nameIndex(m_enumFeatures, 2);  // F_
+    m_commandNames = nameIndex(m_enumCommands, 2);  // C_
+
     QStringList features = config.value("supported_features").toStringList();
     for (int i = 0; i < features.length(); i++) {
         int feature = getFeatureIndex(features[i]);
@@ -201,9 +331,59 @@ void Entity::initializeSupportedFeatures(const QVariantMap& config) {
             qWarning() << "not defined feature" << features[i];
             continue;
         }
-        int byte = feature / 8;
-        int bit  = feature % 8;
-        Q_ASSERT(byte < static_cast<int>(sizeof(m_supported_features)));
-        m_supported_features[byte] |= (1 << bit);
+        Q_ASSERT(feature < MAX_FEATURES);
+        m_supportedFeatures.set(static_cast<size_t>(feature));
+    }
+    for (int i = 0; i < MAX_FEATURES; i++) {
+        if (m_supportedFeatures.test(static_cast<size_t>(i)))
+            m_supportedFeatureNames.append(getFeatureName(i));
+    }
+}
+
+const Entity::EnumNameIndex* Entity::nameIndex(const QMetaEnum* metaEnum, int prefixLength) {
+    static QHash<const QMetaEnum*, const EnumNameIndex*> s_indexes;
+
+    if (metaEnum == nullptr) {
+        return nullptr;
+    }
+    const EnumNameIndex* index = s_indexes.value(metaEnum);
+    if (index == nullptr) {
+        index = new EnumNameIndex(*metaEnum, prefixLength);
+        s_indexes.insert(metaEnum, index);
+    }
+    return index;
+}
+
+// Case insensitive comparison of a name with an enum key, without converting the name
+static int compareKey(const QString& name, const QByteArray& key) {
+    int length = qMin(name.size(), key.size());
+    for (int i = 0; i < length; i++) {
+        ushort a = name.at(i).toUpper().unicode();
+        ushort b = QChar(key.at(i)).toUpper().unicode();
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+    return name.size() - key.size();
+}
+
+Entity::EnumNameIndex::EnumNameIndex(const QMetaEnum& metaEnum, int prefixLength) {
+    m_keys.reserve(metaEnum.keyCount());
+    m_names.reserve(metaEnum.keyCount());
+    for (int i = 0; i < metaEnum.keyCount(); i++) {
+        QByteArray key = QByteArray(metaEnum.key(i)).mid(prefixLength);
+        m_names.append(QString::fromLatin1(key));
+        m_keys.append(qMakePair(key.toUpper(), metaEnum.value(i)));
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+}
+
+int Entity::EnumNameIndex::value(const QString& name) const {
+    auto key = std::lower_bound(
+        m_keys.cbegin(), m_keys.cend(), name,
+        [](const QPair<QByteArray, int>& k, const QString& n) { return compareKey(n, k.first) > 0; });
+    if (key != m_keys.cend() && compareKey(name, key->first) == 0) {
+        return key->second;
     }
+    return -1;
 }
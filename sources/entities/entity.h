@@ -21,10 +21,16 @@
  *****************************************************************************/
 #pragma once
 
+#include <QMetaMethod>
 #include <QObject>
+#include <QPair>
 #include <QString>
 #include <QStringList>
+#include <QVarLengthArray>
 #include <QVariant>
+#include <QVector>
+
+#include <bitset>
 
 #include "yio-interface/entities/entityinterface.h"
 #include "yio-interface/integrationinterface.h"
@@ -39,7 +45,8 @@ class Entity : public QObject, EntityInterface {
                     QObject* parent = nullptr);
     virtual ~Entity();
 
-    static const int MAX_FEATURES = 96;  // Maximum number of features, must be increased if too small
+    static const int MAX_FEATURES   = 96;  // Maximum number of features, must be increased if too small
+    static const int MAX_ATTRIBUTES = 32;  // Maximum number of attributes in the attributesChanged mask
 
     Q_PROPERTY(QString type READ type CONSTANT)
     Q_PROPERTY(QString friendly_name READ friendly_name CONSTANT)
@@ -59,6 +66,7 @@ class Entity : public QObject, EntityInterface {
     Q_PROPERTY(QStringList allAttributes READ allAttributes CONSTANT)
     Q_PROPERTY(QStringList allFeatures READ allFeatures CONSTANT)
     Q_PROPERTY(QStringList allCommands READ allCommands CONSTANT)
+    Q_PROPERTY(bool batchUpdates READ batchUpdates WRITE setBatchUpdates NOTIFY batchUpdatesChanged)
 
     // send command to the integration
     Q_INVOKABLE void command(int command, const QVariant& param);  // Use Command enum C_XXXX
@@ -68,10 +76,20 @@ class Entity : public QObject, EntityInterface {
     // check for feature
     Q_INVOKABLE bool isSupported(int feature);  // Use Feature enum F_XXXXX
 
-    // update an entity with attributes from integration hub, return true in case of change
+    // update an entity with attributes from integration hub, return true in case of change. Updates from other threads
+    // are queued to the thread of the entity and return false.
     Q_INVOKABLE bool update(const QVariantMap& attributes);
     Q_INVOKABLE bool updateAttrByName(const QString& name, const QVariant& value);
-    Q_INVOKABLE bool updateAttrByIndex(int attrIndex, const QVariant& value);  // must be overriden
+    Q_INVOKABLE bool updateAttrByIndex(int attrIndex, const QVariant& value);  // emits attributeChanged on change
+
+    // In batch update mode the change signals of updated attributes are collected and emitted once per event loop
+    // turn, followed by a single attributesChanged signal with the mask of all changed attributes.
+    bool batchUpdates() { return m_batchUpdates; }
+    void setBatchUpdates(bool value);
+
+    // current attribute values, read from the property with the same name as the attribute
+    Q_INVOKABLE QVariant    getAttrValue(int attrIndex);
+    Q_INVOKABLE QVariantMap getAttributes();
 
     // Attribute name and index
     Q_INVOKABLE QString getAttrName(int attrIndex);
@@ -93,6 +111,7 @@ class Entity : public QObject, EntityInterface {
     QString               entity_id() { return objectName(); }
     QString               integration() { return m_integration; }
     IntegrationInterface* integrationObj() { return m_integrationObj; }
+    EntityInterface*      entityInterface() { return this; }
     QStringList           supported_features();
     bool                  favorite() { return m_favorite; }
     void                  setFavorite(bool value);
@@ -115,23 +134,84 @@ class Entity : public QObject, EntityInterface {
     void onChanged();
     void stateTextChanged();
     void connectedChanged();
+    void attributeChanged(int attrIndex);
+    void attributesChanged(int attrMask);  // bit (1 << attrIndex) is set for every changed attribute
+    void batchUpdatesChanged();
 
  protected:
+    /**
+     * @brief The EnumNameIndex class maps the key names of a meta enum case insensitive to their values.
+     * The keys are sorted once, a lookup is a binary search without any memory allocation.
+     */
+    class EnumNameIndex {
+     public:
+        EnumNameIndex(const QMetaEnum& metaEnum, int prefixLength);
+
+        // returns -1 if the name is not found
+        int value(const QString& name) const;
+
+        // key names without prefix, in the order of the enum
+        const QStringList& names() const { return m_names; }
+
+     private:
+        QVector<QPair<QByteArray, int>> m_keys;  // key without prefix, value
+        QStringList                     m_names;
+    };
+
+    // Returns the shared name index of the meta enum. Entity types keep their meta enums in static variables, so
+    // there is only one index per entity type and enum.
+    static const EnumNameIndex* nameIndex(const QMetaEnum* metaEnum, int prefixLength = 0);
+
+    // update a single attribute, return true in case of change
+    virtual bool updateAttribute(int attrIndex, const QVariant& value);  // must be overriden
+
+    // Emits a change signal without arguments. Signals of an attribute update in batch update mode are recorded
+    // instead and emitted once in emitPendingChanges. Use it for all change signals emitted in updateAttribute.
+    template <class T>
+    void notifyChange(void (T::*signal)()) {
+        if (m_collectSignals) {
+            deferSignal(QMetaMethod::fromSignal(signal).methodIndex());
+        } else {
+            (static_cast<T*>(this)->*signal)();
+        }
+    }
+
     void initializeSupportedFeatures(
         const QVariantMap& config);  // !!!! must be called in every concrete entity constructor !!!!
 
-    IntegrationInterface* m_integrationObj;
-    QString               m_type;
-    QString               m_area;
-    QString               m_friendly_name;
-    QString               m_integration;
-    bool                  m_favorite;
-    bool                  m_connected;
-    quint8                m_supported_features[(MAX_FEATURES + 7) / 8];
-    int                   m_state;
-    QMetaEnum*            m_enumState;
-    QMetaEnum*            m_enumAttr;
-    QMetaEnum*            m_enumFeatures;
-    QMetaEnum*            m_enumCommands;
-    void*                 m_specificInterface;
+ private:
+    // property with the same name as the attribute, -1 if there is none
+    int attrPropertyIndex(int attrIndex);
+
+    // records a signal for emitPendingChanges, every signal is recorded once
+    void deferSignal(int methodIndex);
+
+    // emits the collected change signals of the batch update mode
+    void emitPendingChanges();
+
+ protected:
+
+    IntegrationInterface*     m_integrationObj;
+    QString                   m_type;
+    QString                   m_area;
+    QString                   m_friendly_name;
+    QString                   m_integration;
+    bool                      m_favorite;
+    bool                      m_connected;
+    std::bitset<MAX_FEATURES> m_supportedFeatures;
+    QStringList               m_supportedFeatureNames;  // the supported features never change, built once
+    int                       m_state;
+    QMetaEnum*                m_enumState;
+    QMetaEnum*                m_enumAttr;
+    QMetaEnum*                m_enumFeatures;
+    QMetaEnum*                m_enumCommands;
+    const EnumNameIndex*      m_stateNames;
+    const EnumNameIndex*      m_attrNames;
+    const EnumNameIndex*      m_featureNames;
+    const EnumNameIndex*      m_commandNames;
+    void*                     m_specificInterface;
+    bool                      m_batchUpdates;
+    quint32                   m_pendingChanges;  // changed attributes not yet signaled in batch update mode
+    QVarLengthArray<int, 8>   m_pendingSignals;  // recorded change signals, method index in emission order
+    bool                      m_collectSignals;  // true while notifyChange records the signals
 };
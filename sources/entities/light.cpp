@@ -29,7 +29,7 @@ LightInterface::~LightInterface() {}
 
 QString Light::Type = "light";
 
-bool Light::updateAttrByIndex(int attrIndex, const QVariant& value) {
+bool Light::updateAttribute(int attrIndex, const QVariant& value) {
     bool chg = false;
     switch (attrIndex) {
         case LightDef::STATE:
@@ -42,21 +42,21 @@ bool Light::updateAttrByIndex(int attrIndex, const QVariant& value) {
             if (m_brightness != value.toInt()) {
                 m_brightness = value.toInt();
                 chg          = true;
-                emit brightnessChanged();
+                notifyChange(&Light::brightnessChanged);
             }
             break;
         case LightDef::COLOR:
             if (m_color != value) {
                 m_color = QColor(value.toString());
                 chg     = true;
-                emit colorChanged();
+                notifyChange(&Light::colorChanged);
             }
             break;
         case LightDef::COLORTEMP:
             if (m_colorTemp != value) {
                 m_colorTemp = value.toInt();
                 chg         = true;
-                emit colorTempChanged();
+                notifyChange(&Light::colorTempChanged);
             }
             break;
     }
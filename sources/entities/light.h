@@ -45,7 +45,7 @@ class Light : public Entity, LightInterface {
     Q_INVOKABLE void setColor(QColor value);
     Q_INVOKABLE void setColorTemp(int value);
 
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
 
     void   turnOn() override;
     void   turnOff() override;
@@ -29,7 +29,7 @@
 MediaPlayerInterface::~MediaPlayerInterface() {}
 QString MediaPlayer::Type = "media_player";
 
-bool MediaPlayer::updateAttrByIndex(int attrIndex, const QVariant &value) {
+bool MediaPlayer::updateAttribute(int attrIndex, const QVariant &value) {
     bool chg = false;
     switch (attrIndex) {
         case MediaPlayerDef::STATE:
@@ -48,63 +48,63 @@ bool MediaPlayer::updateAttrByIndex(int attrIndex, const QVariant &value) {
             if (m_source != value.toString()) {
                 m_source = value.toString();
                 chg      = true;
-                emit sourceChanged();
+                notifyChange(&MediaPlayer::sourceChanged);
             }
             break;
         case MediaPlayerDef::VOLUME:
             if (m_volume != value.toInt()) {
                 m_volume = value.toInt();
                 chg      = true;
-                emit volumeChanged();
+                notifyChange(&MediaPlayer::volumeChanged);
             }
             break;
         case MediaPlayerDef::MUTED:
             if (m_muted != value.toBool()) {
                 m_muted = value.toBool();
                 chg     = true;
-                emit mutedChanged();
+                notifyChange(&MediaPlayer::mutedChanged);
             }
             break;
         case MediaPlayerDef::MEDIATYPE:
             if (m_mediaType != value.toString()) {
                 m_mediaType = value.toString();
                 chg         = true;
-                emit mediaTypeChanged();
+                notifyChange(&MediaPlayer::mediaTypeChanged);
             }
             break;
         case MediaPlayerDef::MEDIATITLE:
             if (m_mediaTitle != value.toString()) {
                 m_mediaTitle = value.toString();
                 chg          = true;
-                emit mediaTitleChanged();
+                notifyChange(&MediaPlayer::mediaTitleChanged);
             }
             break;
         case MediaPlayerDef::MEDIAARTIST:
             if (m_mediaArtist != value.toString()) {
                 m_mediaArtist = value.toString();
                 chg           = true;
-                emit mediaArtistChanged();
+                notifyChange(&MediaPlayer::mediaArtistChanged);
             }
             break;
         case MediaPlayerDef::MEDIAIMAGE:
             if (m_mediaImage != value.toString()) {
                 m_mediaImage = value.toString();
                 chg          = true;
-                emit mediaImageChanged();
+                notifyChange(&MediaPlayer::mediaImageChanged);
             }
             break;
         case MediaPlayerDef::MEDIADURATION:
             if (m_mediaDuration != value.toInt()) {
                 m_mediaDuration = value.toInt();
                 chg             = true;
-                emit mediaDurationChanged();
+                notifyChange(&MediaPlayer::mediaDurationChanged);
             }
             break;
         case MediaPlayerDef::MEDIAPROGRESS:
             if (m_mediaProgress != value.toInt()) {
                 m_mediaProgress = value.toInt();
                 chg             = true;
-                emit mediaProgressChanged();
+                notifyChange(&MediaPlayer::mediaProgressChanged);
             }
             break;
     }
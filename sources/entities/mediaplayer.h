@@ -78,7 +78,7 @@ class MediaPlayer : public Entity, MediaPlayerInterface {
 
     bool isOn() override { return m_state == MediaPlayerDef::ON || m_state == MediaPlayerDef::PLAYING; }
     bool supportsOn() override;
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
     void turnOn() override;
     void turnOff() override;
 
@@ -28,7 +28,7 @@ SwitchInterface::~SwitchInterface() {}
 
 QString Switch::Type = "switch";
 
-bool Switch::updateAttrByIndex(int attrIndex, const QVariant& value) {
+bool Switch::updateAttribute(int attrIndex, const QVariant& value) {
     bool chg = false;
     switch (attrIndex) {
         case SwitchDef::STATE:
@@ -41,7 +41,7 @@ bool Switch::updateAttrByIndex(int attrIndex, const QVariant& value) {
             if (m_power != value.toInt()) {
                 m_power = value.toInt();
                 chg = true;
-                emit powerChanged();
+                notifyChange(&Switch::powerChanged);
             }
             break;
     }
@@ -38,7 +38,7 @@ class Switch : public Entity, SwitchInterface {
     // switch commands
     Q_INVOKABLE void toggle();
 
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
 
     void turnOn() override;
     void turnOff() override;
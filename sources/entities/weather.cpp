@@ -28,7 +28,7 @@ WeatherInterface::~WeatherInterface() {}
 
 QString Weather::Type = "weather";
 
-bool Weather::updateAttrByIndex(int attrIndex, const QVariant& value) {
+bool Weather::updateAttribute(int attrIndex, const QVariant& value) {
     bool chg = false;
     switch (attrIndex) {
         case WeatherDef::STATE:
@@ -41,12 +41,12 @@ bool Weather::updateAttrByIndex(int attrIndex, const QVariant& value) {
         case WeatherDef::CURRENT:
             m_current = value.toMap();
             chg = true;
-            emit currentChanged();
+            notifyChange(&Weather::currentChanged);
             break;
         case WeatherDef::FORECAST:
             m_forecast = value.toList();
             chg = true;
-            emit forecastChanged();
+            notifyChange(&Weather::forecastChanged);
             break;
         */
         default:
@@ -55,7 +55,7 @@ class Weather : public Entity, WeatherInterface {
     Q_PROPERTY(QObject* forecast READ forecast NOTIFY forecastChanged)
 
     // update an entity's attributes
-    bool updateAttrByIndex(int attrIndex, const QVariant& value) override;
+    bool updateAttribute(int attrIndex, const QVariant& value) override;
 
     QWeatherItem* current() { return &m_current; }
     QObject*      forecast() { return m_forecast; }
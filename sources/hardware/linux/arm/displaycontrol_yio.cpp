@@ -30,6 +30,7 @@
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtDebug>
 
+#include "../../../wakelatency.h"
 #include "mcp23017_handler.h"
 
 #define CLK 107
@@ -269,4 +270,5 @@ void DisplayControlYioThread::enterStandby() {
 void DisplayControlYioThread::leaveStandby() {
     spi_screenreg_set(0x29, 0xffff, 0xffff);
     spi_screenreg_set(0x11, 0xffff, 0xffff);
+    WakeLatency::trace(WakeLatency::PHASE_DISPLAY);
 }
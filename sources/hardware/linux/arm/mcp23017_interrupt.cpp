@@ -26,6 +26,8 @@
 #include <QLoggingCategory>
 #include <QtDebug>
 
+#include "../../../wakelatency.h"
+
 static Q_LOGGING_CATEGORY(CLASS_LC, "hw.dev.MCP23017");
 
 Mcp23017InterruptHandler::Mcp23017InterruptHandler(const QString& i2cDevice, int i2cDeviceId, int gpio, QObject* parent)
@@ -107,6 +109,8 @@ bool Mcp23017InterruptHandler::setupGPIO() {
 }
 
 void Mcp23017InterruptHandler::interruptHandler() {
+    qint64 timestamp = WakeLatency::now();
+
     QFile file(m_gpioValueDevice);
     if (!file.open(QIODevice::ReadOnly)) {
         qCCritical(CLASS_LC) << "Error opening:" << m_gpioValueDevice;
@@ -119,6 +123,10 @@ void Mcp23017InterruptHandler::interruptHandler() {
     if (gpioVal == 0) {
         // check the MCP23017 what caused the interrupt
         int  e = mcp.readInterrupt();
+        if (e != BATTERY) {
+            WakeLatency::interrupt(e == APDS9960 ? WakeLatency::SOURCE_PROXIMITY : WakeLatency::SOURCE_BUTTON,
+                                   timestamp);
+        }
         emit interruptEvent(e);
     }
     delay(10);
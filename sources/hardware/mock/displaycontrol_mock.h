@@ -24,6 +24,7 @@
 
 #include <QScreen>
 
+#include "../../wakelatency.h"
 #include "../displaycontrol.h"
 
 class DisplayControlMock : public DisplayControl {
@@ -35,7 +36,9 @@ class DisplayControlMock : public DisplayControl {
     // DisplayControl interface
  public:
     bool setMode(Mode mode) override {
-        Q_UNUSED(mode)
+        if (mode == StandbyOff) {
+            WakeLatency::trace(WakeLatency::PHASE_DISPLAY);
+        }
         return true;
     }
 
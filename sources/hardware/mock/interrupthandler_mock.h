@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../../wakelatency.h"
 #include "../interrupthandler.h"
 
 class InterruptHandlerMock : public InterruptHandler {
@@ -32,4 +33,12 @@ class InterruptHandlerMock : public InterruptHandler {
     // InterruptHandler interface
  public:
     void shutdown() override {}
+
+    // replays an interrupt of the given InterruptHandler::Events
+    Q_INVOKABLE void simulateInterrupt(int event) {
+        if (event != BATTERY) {
+            WakeLatency::interrupt(event == APDS9960 ? WakeLatency::SOURCE_PROXIMITY : WakeLatency::SOURCE_BUTTON);
+        }
+        emit interruptEvent(event);
+    }
 };
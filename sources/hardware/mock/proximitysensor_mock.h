@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../../wakelatency.h"
 #include "../proximitysensor.h"
 
 class ProximitySensorMock : public ProximitySensor {
@@ -39,6 +40,12 @@ class ProximitySensorMock : public ProximitySensor {
     void setProximitySetting(int proximity) override { m_proximitySetting = proximity; }
     int  proximity() override { return 0; }
 
+    // replays a proximity interrupt
+    Q_INVOKABLE void simulateProximity() {
+        WakeLatency::interrupt(WakeLatency::SOURCE_PROXIMITY);
+        emit proximityEvent();
+    }
+
  private:
     int m_proximitySetting = 70;
 };
@@ -25,6 +25,8 @@
 #include <QLoggingCategory>
 #include <QtDebug>
 
+#include "../wakelatency.h"
+
 static Q_LOGGING_CATEGORY(CLASS_LC, "hw.touchevent");
 
 TouchEventFilter *TouchEventFilter::s_instance = nullptr;
@@ -62,6 +64,7 @@ bool TouchEventFilter::eventFilter(QObject *obj, QEvent *event) {
     switch (event->type()) {
         case QEvent::TouchBegin:
         case QEvent::MouseButtonPress:
+            WakeLatency::interrupt(WakeLatency::SOURCE_TOUCH);
             emit detectedChanged();
             break;
         default:  // do nothing
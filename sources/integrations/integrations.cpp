@@ -22,8 +22,16 @@
 
 #include "integrations.h"
 
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
 #include <QLoggingCategory>
 #include <QPluginLoader>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
 #include <QtDebug>
 
 #include "../config.h"
@@ -38,7 +46,41 @@ Integrations* Integrations::s_instance = nullptr;
 
 static Q_LOGGING_CATEGORY(CLASS_LC, "plugin");
 
-Integrations::Integrations(const QString& pluginPath) : m_pluginPath(pluginPath) {
+/**
+ * @brief Opens a plugin shared object and creates its root object on the thread pool.
+ * The plugin object is moved to the thread of Integrations and handed over with a queued call of onPluginLoaded.
+ */
+class PluginLoadTask : public QRunnable {
+ public:
+    PluginLoadTask(Integrations* integrations, const QString& type, const QString& pluginPath)
+        : m_integrations(integrations), m_type(type), m_pluginPath(pluginPath) {}
+
+    void run() override {
+        QPluginLoader pluginLoader(m_pluginPath);
+
+        QJsonObject metaData = pluginLoader.metaData()["MetaData"].toObject();
+        qCInfo(CLASS_LC) << "LOADING PLUGIN:" << m_pluginPath << "version:" << metaData["version"].toString();
+
+        QString  error;
+        QObject* plugin = pluginLoader.instance();
+        if (plugin) {
+            plugin->moveToThread(m_integrations->thread());
+        } else {
+            error = pluginLoader.errorString();
+        }
+
+        QMetaObject::invokeMethod(m_integrations, "onPluginLoaded", Qt::QueuedConnection, Q_ARG(QString, m_type),
+                                  Q_ARG(QObject*, plugin), Q_ARG(QString, error));
+    }
+
+ private:
+    Integrations* m_integrations;
+    QString       m_type;
+    QString       m_pluginPath;
+};
+
+Integrations::Integrations(const QString& pluginPath)
+    : m_pluginPath(pluginPath), m_scheduler(new IntegrationScheduler(this)) {
     s_instance = this;
 
     const QMetaObject& metaObject             = IntegrationsSupported::staticMetaObject;
@@ -53,19 +95,6 @@ Integrations::Integrations(const QString& pluginPath) : m_pluginPath(pluginPath)
     }
 }
 
-QObject* Integrations::loadPlugin(const QString& type) {
-    Launcher* l   = new Launcher();
-    QObject*  obj = l->loadPlugin(m_pluginPath, type);
-
-    // store the plugin objects
-    m_plugins.insert(type, obj);
-
-    // cleanup
-    l->deleteLater();
-
-    return obj;
-}
-
 QObject* Integrations::getPlugin(const QString& type) { return m_plugins.value(type); }
 
 QList<QObject*> Integrations::getAllPlugins() { return m_plugins.values(); }
@@ -93,11 +122,71 @@ void Integrations::createInstance(QObject* pluginObj, QVariantMap map) {
 }
 
 QJsonObject Integrations::getPluginMetaData(const QString& pluginName) {
-    Launcher* launcher   = new Launcher();
-    QString   pluginPath = launcher->getPluginPath(m_pluginPath, pluginName);
-    qCDebug(CLASS_LC()) << "Getting metadata for:" << pluginPath;
-    QPluginLoader pluginLoader(pluginPath);
-    return pluginLoader.metaData()["MetaData"].toObject();
+    loadMetaDataIndex();
+    return m_pluginMetaData.value(pluginName);
+}
+
+void Integrations::loadMetaDataIndex() {
+    if (m_metaDataIndexLoaded) {
+        return;
+    }
+    m_metaDataIndexLoaded = true;
+
+    QString indexPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/plugins.json";
+
+    // index of the last run: type -> {path, mtime, size, metadata}
+    QJsonObject index;
+    QFile       indexFile(indexPath);
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        index = QJsonDocument::fromJson(indexFile.readAll()).object();
+        indexFile.close();
+    }
+
+    bool changed = false;
+    for (const QString& type : m_supportedIntegrations) {
+        // the plugin path has no library suffix on Linux, the loader resolves the file name without loading it
+        QPluginLoader pluginLoader(Launcher::getPluginPath(m_pluginPath, type));
+        QString       pluginPath = pluginLoader.fileName();
+        QFileInfo     pluginFile(pluginPath);
+        if (pluginPath.isEmpty() || !pluginFile.exists()) {
+            changed |= index.contains(type);
+            index.remove(type);
+            continue;
+        }
+
+        QJsonObject entry = index.value(type).toObject();
+        qint64      mtime = pluginFile.lastModified().toMSecsSinceEpoch();
+        if (entry.value("path").toString() != pluginPath || entry.value("mtime").toVariant().toLongLong() != mtime ||
+            entry.value("size").toVariant().toLongLong() != pluginFile.size()) {
+            qCDebug(CLASS_LC()) << "Getting metadata for:" << pluginPath;
+            entry.insert("path", pluginPath);
+            entry.insert("mtime", QString::number(mtime));
+            entry.insert("size", QString::number(pluginFile.size()));
+            entry.insert("metadata", pluginLoader.metaData()["MetaData"].toObject());
+            index.insert(type, entry);
+            changed = true;
+        }
+
+        QJsonObject metaData = entry.value("metadata").toObject();
+        m_pluginMetaData.insert(type, metaData);
+        QString mdns = metaData.value("mdns").toString();
+        if (!mdns.isEmpty() && !m_pluginTypesByMdns.contains(mdns)) {
+            m_pluginTypesByMdns.insert(mdns, type);
+        }
+    }
+
+    if (changed) {
+        QDir().mkpath(QFileInfo(indexPath).absolutePath());
+        QSaveFile file(indexPath);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+            if (!file.commit()) {
+                qCWarning(CLASS_LC()) << "Cannot write plugin metadata index:" << indexPath << file.errorString();
+            }
+        } else {
+            qCWarning(CLASS_LC()) << "Cannot write plugin metadata index:" << indexPath << file.errorString();
+        }
+    }
 }
 
 // Integrations::~Integrations() { s_instance = nullptr; }
@@ -112,28 +201,63 @@ void Integrations::load() {
 
     // let's load the plugins
     for (QVariantMap::const_iterator iter = c.begin(); iter != c.end(); ++iter) {
-        QObject* obj;
-        if (!isPluginLoaded(iter.key())) {
-            // load the plugin
-            obj = loadPlugin(iter.key());
-        } else {
-            obj = getPlugin(iter.key());
-        }
-
         // push the config to the integration
         QVariantMap map = iter.value().toMap();
         map.insert(Config::KEY_TYPE, iter.key());
 
-        // create instance of the integration
         m_integrationsToLoad++;
-        createInstance(obj, map);
+        if (isPluginLoaded(iter.key())) {
+            // create instance of the integration
+            createInstance(getPlugin(iter.key()), map);
+        } else {
+            // the instance is created when the plugin is loaded
+            bool loading = m_pendingInstances.contains(iter.key());
+            m_pendingInstances[iter.key()].append(map);
+            if (!loading) {
+                loadPluginAsync(iter.key());
+            }
+        }
     }
+    emit loadProgressChanged();
 
     if (m_integrationsToLoad == 0) {
         emit loadComplete();
     }
 }
 
+qreal Integrations::loadProgress() {
+    return m_integrationsToLoad == 0 ? 1 : static_cast<qreal>(m_integrationsLoaded) / m_integrationsToLoad;
+}
+
+void Integrations::loadPluginAsync(const QString& type) {
+    QThreadPool::globalInstance()->start(new PluginLoadTask(this, type, Launcher::getPluginPath(m_pluginPath, type)));
+}
+
+void Integrations::onPluginLoaded(const QString& type, QObject* plugin, const QString& error) {
+    QList<QVariantMap> configs = m_pendingInstances.take(type);
+
+    if (!plugin) {
+        qCCritical(CLASS_LC) << "FAILED TO LOAD PLUGIN:" << type << error;
+        Notifications::getInstance()->add(true, "Failed to load " + type);
+
+        // the integrations of the plugin will never report createDone
+        m_integrationsLoaded += configs.count();
+        emit loadProgressChanged();
+        if (m_integrationsLoaded == m_integrationsToLoad) {
+            emit loadComplete();
+        }
+        return;
+    }
+
+    // store the plugin objects
+    m_plugins.insert(type, plugin);
+
+    for (const QVariantMap& map : configs) {
+        // create instance of the integration
+        createInstance(plugin, map);
+    }
+}
+
 void Integrations::onCreateDone(QMap<QObject*, QVariant> map) {
     // add the integrations to the integration database
     for (QMap<QObject*, QVariant>::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
@@ -142,6 +266,7 @@ void Integrations::onCreateDone(QMap<QObject*, QVariant> map) {
     m_integrationsLoaded++;
 
     qCDebug(CLASS_LC) << "Integrations loaded:" << m_integrationsLoaded << "from:" << m_integrationsToLoad;
+    emit loadProgressChanged();
 
     if (m_integrationsLoaded == m_integrationsToLoad) {
         emit loadComplete();
@@ -162,16 +287,30 @@ QStringList Integrations::listIds() {
 
 QObject* Integrations::get(const QString& id) { return m_integrations.value(id); }
 
+void Integrations::invoke(QObject* integration, const QString& method) {
+    QByteArray name = method.toUtf8();
+    bool       posted = m_scheduler->post(m_integrations.key(integration), [=](IntegrationInterface*) {
+        if (!QMetaObject::invokeMethod(integration, name.constData())) {
+            qCWarning(CLASS_LC()) << "Cannot invoke" << name << "of integration" << integration;
+        }
+    });
+    if (!posted) {
+        qCWarning(CLASS_LC()) << "Cannot invoke" << name << "of unknown integration" << integration;
+    }
+}
+
 void Integrations::add(const QVariantMap& config, QObject* obj, const QString& type) {
     qCDebug(CLASS_LC()) << "Adding integration:" << type;
     const QString id = config.value(Config::KEY_ID).toString();
     m_integrations.insert(id, obj);
     m_integrationsFriendlyNames.insert(id, config.value(Config::KEY_FRIENDLYNAME).toString());
     m_integrationsTypes.insert(id, type);
+    m_scheduler->add(id, obj, config);
     emit listChanged();
 }
 
 void Integrations::remove(const QString& id) {
+    m_scheduler->remove(id);
     m_integrations.remove(id);
     m_integrationsFriendlyNames.remove(id);
     emit listChanged();
@@ -187,9 +326,10 @@ QString Integrations::getFriendlyName(QObject* obj) {
 QString Integrations::getMDNS(const QString& id) { return m_integrationsMdns.value(id); }
 
 QStringList Integrations::getMDNSList() {
+    loadMetaDataIndex();
     QStringList mdnsList;
     for (int i = 0; i < m_supportedIntegrations.length(); i++) {
-        mdnsList.append(getPluginMetaData(m_supportedIntegrations[i]).toVariantMap().value("mdns").toString());
+        mdnsList.append(m_pluginMetaData.value(m_supportedIntegrations[i]).value("mdns").toString());
     }
 
     return mdnsList;
@@ -198,11 +338,6 @@ QStringList Integrations::getMDNSList() {
 QString Integrations::getType(const QString& id) { return m_integrationsTypes.value(id); }
 
 QString Integrations::getTypeByMdns(const QString& mdns) {
-    for (int i = 0; i < m_supportedIntegrations.length(); i++) {
-        if (getPluginMetaData(m_supportedIntegrations[i]).toVariantMap().value("mdns").toString() == mdns) {
-            return m_supportedIntegrations[i];
-        }
-    }
-
-    return "";
+    loadMetaDataIndex();
+    return m_pluginTypesByMdns.value(mdns);
 }
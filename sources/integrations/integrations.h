@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <QHash>
+#include <QJsonObject>
 #include <QMap>
 #include <QObject>
 
+#include "integrationscheduler.h"
 #include "integrations_supported.h"
 #include "integrationsinterface.h"
 #include "yio-interface/integrationinterface.h"
@@ -38,9 +41,14 @@ class Integrations : public QObject, IntegrationsInterface {
     // list of all integrations
     Q_PROPERTY(QList<QObject*> list READ list NOTIFY listChanged)
 
-    // load all integrations from config file
+    // progress of load() from 0 to 1
+    Q_PROPERTY(qreal loadProgress READ loadProgress NOTIFY loadProgressChanged)
+
+    // load all integrations from config file, the plugins are loaded in parallel on the thread pool
     Q_INVOKABLE void load();
 
+    qreal loadProgress();
+
     // get all integrations
     QList<QObject*> list();
 
@@ -50,6 +58,9 @@ class Integrations : public QObject, IntegrationsInterface {
     // get an integration object by id
     Q_INVOKABLE QObject* get(const QString& id);
 
+    // queued call of a method without arguments on the thread of the integration, for QML, e.g. "connect"
+    Q_INVOKABLE void invoke(QObject* integration, const QString& method);
+
     // add an integration
     void add(const QVariantMap& config, QObject* obj, const QString& type) override;
 
@@ -74,7 +85,6 @@ class Integrations : public QObject, IntegrationsInterface {
     explicit Integrations(const QString& pluginPath);
 
     // get all plugins
-    QObject*        loadPlugin(const QString& type);
     QObject*        getPlugin(const QString& type);
     QList<QObject*> getAllPlugins();
     bool            isPluginLoaded(const QString& type);
@@ -82,19 +92,33 @@ class Integrations : public QObject, IntegrationsInterface {
     // create integration instance
     void createInstance(QObject* pluginObj, QVariantMap map);
 
-    // get plugin metadata
+    // get plugin metadata, read from the metadata index
     QJsonObject getPluginMetaData(const QString& pluginName);
 
+    // threads of the integration instances
+    IntegrationScheduler* scheduler() { return m_scheduler; }
+
     static Integrations* getInstance() { return s_instance; }
 
  signals:
     void listChanged();
     void loadComplete();
+    void loadProgressChanged();
 
  public slots:  // NOLINT open issue: https://github.com/cpplint/cpplint/pull/99
     void onCreateDone(QMap<QObject*, QVariant> map);
 
+ private slots:  // NOLINT open issue: https://github.com/cpplint/cpplint/pull/99
+    // called from the thread pool when a plugin is loaded, plugin is null if loading failed
+    void onPluginLoaded(const QString& type, QObject* plugin, const QString& error);
+
  private:
+    void loadPluginAsync(const QString& type);
+
+    // Builds the metadata index of the supported plugins. Metadata of unchanged plugin files (same modification time
+    // and size) is taken from the index file of the last run, only new or changed plugins are read.
+    void loadMetaDataIndex();
+
     QStringList m_supportedIntegrations;
 
     QMap<QString, QObject*> m_plugins;
@@ -103,9 +127,18 @@ class Integrations : public QObject, IntegrationsInterface {
     QMap<QString, QString>  m_integrationsMdns;
     QMap<QString, QString>  m_integrationsTypes;
     QString                 m_pluginPath;
+    IntegrationScheduler*   m_scheduler;
     int                     m_integrationsToLoad = 0;
     int                     m_integrationsLoaded = 0;
 
+    // integration configs waiting for their plugin to be loaded
+    QMap<QString, QList<QVariantMap>> m_pendingInstances;
+
+    // plugin metadata index: type -> metadata and mdns service -> type
+    QHash<QString, QJsonObject> m_pluginMetaData;
+    QHash<QString, QString>     m_pluginTypesByMdns;
+    bool                        m_metaDataIndexLoaded = false;
+
     static Integrations* s_instance;
 
  protected:
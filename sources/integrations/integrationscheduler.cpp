@@ -0,0 +1,214 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2018-2019 Marton Borzak <hello@martonborzak.com>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include "integrationscheduler.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QtDebug>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "../config.h"
+
+static Q_LOGGING_CATEGORY(CLASS_LC, "plugin");
+
+IntegrationThread::IntegrationThread(const QString& name, QObject* parent)
+    : QThread(parent), m_clockValid(0), m_clockId(0) {
+    setObjectName(name);
+}
+
+void IntegrationThread::run() {
+#ifdef Q_OS_LINUX
+    clockid_t clockId;
+    if (pthread_getcpuclockid(pthread_self(), &clockId) == 0) {
+        m_clockId = static_cast<int>(clockId);
+        m_clockValid.storeRelease(1);
+    }
+#endif
+    exec();
+    m_clockValid.storeRelease(0);
+}
+
+qint64 IntegrationThread::cpuTime() {
+#ifdef Q_OS_LINUX
+    struct timespec time;
+    if (m_clockValid.loadAcquire() && clock_gettime(static_cast<clockid_t>(m_clockId), &time) == 0) {
+        return static_cast<qint64>(time.tv_sec) * 1000 + time.tv_nsec / 1000000;
+    }
+#endif
+    return -1;
+}
+
+IntegrationScheduler::IntegrationScheduler(QObject* parent) : QObject(parent), m_sharedThread(nullptr) {}
+
+IntegrationScheduler::~IntegrationScheduler() {
+    for (const QSharedPointer<ScheduledIntegration>& scheduled : m_integrations) {
+        if (scheduled->dedicated) {
+            stopThread(scheduled->thread);
+        }
+    }
+    if (m_sharedThread) {
+        stopThread(m_sharedThread);
+    }
+}
+
+void IntegrationScheduler::add(const QString& id, QObject* integration, const QVariantMap& config) {
+    QSharedPointer<ScheduledIntegration> scheduled(new ScheduledIntegration());
+    scheduled->object    = integration;
+    scheduled->thread    = nullptr;
+    scheduled->dedicated = false;
+
+    QString placement = config.value(Config::KEY_WORKERTHREAD).toString();
+    if (integration->parent() != nullptr) {
+        if (placement == "dedicated" || placement == "shared") {
+            qCWarning(CLASS_LC) << "Integration" << id << "has a parent and stays on the GUI thread";
+        }
+    } else if (placement == "dedicated") {
+        scheduled->thread    = new IntegrationThread(id);
+        scheduled->dedicated = true;
+        scheduled->thread->start();
+    } else if (placement == "shared") {
+        scheduled->thread = sharedThread();
+    }
+
+    if (scheduled->thread) {
+        qCDebug(CLASS_LC) << "Integration" << id << "runs on thread" << scheduled->thread->objectName();
+        integration->moveToThread(scheduled->thread);
+    }
+
+    remove(id);
+    m_integrations.insert(id, scheduled);
+}
+
+void IntegrationScheduler::remove(const QString& id) {
+    QSharedPointer<ScheduledIntegration> scheduled = m_integrations.take(id);
+    if (scheduled.isNull() || scheduled->thread == nullptr) {
+        return;
+    }
+
+    // An object can only be pushed to another thread from its own thread. The hand-back is queued behind the pending
+    // calls of the integration, so the caller never waits for it. The dedicated thread stops itself afterwards.
+    if (scheduled->dedicated) {
+        connect(scheduled->thread, &QThread::finished, scheduled->thread, &QObject::deleteLater);
+    }
+    QThread* guiThread = thread();
+    QMetaObject::invokeMethod(scheduled->object,
+                              [=]() {
+                                  scheduled->object->moveToThread(guiThread);
+                                  if (scheduled->dedicated) {
+                                      scheduled->thread->quit();
+                                  }
+                              },
+                              Qt::QueuedConnection);
+}
+
+void IntegrationScheduler::invoke(const QString& id, LifecycleMethod method, const std::function<void()>& done) {
+    if (!post(id, [method](IntegrationInterface* integration) { (integration->*method)(); }, done) && done) {
+        done();
+    }
+}
+
+bool IntegrationScheduler::post(const QString& id, const std::function<void(IntegrationInterface*)>& call,
+                                const std::function<void()>& done) {
+    QSharedPointer<ScheduledIntegration> scheduled = m_integrations.value(id);
+    IntegrationInterface* integration = scheduled ? qobject_cast<IntegrationInterface*>(scheduled->object) : nullptr;
+    if (integration == nullptr) {
+        return false;
+    }
+
+    scheduled->pendingCalls.ref();
+    QElapsedTimer posted;
+    posted.start();
+    QMetaObject::invokeMethod(scheduled->object,
+                              [=]() {
+                                  scheduled->queueLatency.store(posted.elapsed());
+                                  scheduled->pendingCalls.deref();
+                                  call(integration);
+                                  if (done) {
+                                      done();
+                                  }
+                              },
+                              Qt::QueuedConnection);
+    return true;
+}
+
+void IntegrationScheduler::invokeAll(LifecycleMethod method, const std::function<void()>& done) {
+    if (!done) {
+        for (auto iter = m_integrations.cbegin(); iter != m_integrations.cend(); ++iter) {
+            invoke(iter.key(), method);
+        }
+        return;
+    }
+
+    // the integrations return on their threads in any order, the last one calls done. The extra reference is
+    // released after all calls are queued, so done is called once even if there are no integrations.
+    QSharedPointer<QAtomicInt> remaining(new QAtomicInt(m_integrations.size() + 1));
+    std::function<void()>      returned = [=]() {
+        if (!remaining->deref()) {
+            done();
+        }
+    };
+    for (auto iter = m_integrations.cbegin(); iter != m_integrations.cend(); ++iter) {
+        invoke(iter.key(), method, returned);
+    }
+    returned();
+}
+
+QVariantMap IntegrationScheduler::statistics() {
+    QVariantMap statistics;
+    for (auto iter = m_integrations.cbegin(); iter != m_integrations.cend(); ++iter) {
+        const QSharedPointer<ScheduledIntegration>& scheduled = iter.value();
+
+        QVariantMap map;
+        map.insert("thread", scheduled->thread == nullptr ? "gui" : (scheduled->dedicated ? "dedicated" : "shared"));
+        if (scheduled->thread) {
+            map.insert("cpu_time", scheduled->thread->cpuTime());
+        }
+        map.insert("pending_calls", scheduled->pendingCalls.loadAcquire());
+        map.insert("queue_latency", scheduled->queueLatency.loadAcquire());
+        statistics.insert(iter.key(), map);
+    }
+    return statistics;
+}
+
+IntegrationThread* IntegrationScheduler::sharedThread() {
+    if (m_sharedThread == nullptr) {
+        m_sharedThread = new IntegrationThread("integrations");
+        m_sharedThread->start();
+    }
+    return m_sharedThread;
+}
+
+void IntegrationScheduler::stopThread(IntegrationThread* thread) {
+    thread->quit();
+    if (!thread->wait(3000)) {
+        qCWarning(CLASS_LC) << "Integration thread" << thread->objectName() << "does not stop";
+        thread->terminate();
+        thread->wait();
+    }
+    delete thread;
+}
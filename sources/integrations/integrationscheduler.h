@@ -0,0 +1,114 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2018-2019 Marton Borzak <hello@martonborzak.com>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#pragma once
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVariant>
+
+#include <functional>
+
+#include "yio-interface/integrationinterface.h"
+
+/**
+ * @brief The IntegrationThread class is a managed thread for integration instances which measures its own CPU time.
+ */
+class IntegrationThread : public QThread {
+    Q_OBJECT
+
+ public:
+    explicit IntegrationThread(const QString& name, QObject* parent = nullptr);
+
+    // CPU time of the thread in milliseconds, -1 if not available on this platform
+    qint64 cpuTime();
+
+ protected:
+    void run() override;
+
+ private:
+    QAtomicInt m_clockValid;
+    int        m_clockId;
+};
+
+/**
+ * @brief The IntegrationScheduler class places the integration instances on threads owned by the core.
+ * The thread is chosen with the Config::KEY_WORKERTHREAD value of the integration config:
+ * "dedicated" for an own thread, "shared" for the thread shared by all such integrations. Otherwise the integration
+ * stays on the GUI thread, also with true: such plugins create their own worker thread. Lifecycle calls are always
+ * queued, so the caller never waits for an integration.
+ */
+class IntegrationScheduler : public QObject {
+    Q_OBJECT
+
+ public:
+    typedef void (IntegrationInterface::*LifecycleMethod)();
+
+    explicit IntegrationScheduler(QObject* parent = nullptr);
+    ~IntegrationScheduler() override;
+
+    // place an integration instance on its thread, the integration object must not have a parent
+    void add(const QString& id, QObject* integration, const QVariantMap& config);
+
+    // move an integration instance back to the GUI thread and stop its dedicated thread, both queued: the integration
+    // is on the GUI thread when its pending calls have finished
+    void remove(const QString& id);
+
+    // Queued call of a lifecycle method, e.g. &IntegrationInterface::enterStandby. The optional done function is called
+    // when the method has returned, on the thread of the integration that returned last.
+    void invoke(const QString& id, LifecycleMethod method, const std::function<void()>& done = nullptr);
+    void invokeAll(LifecycleMethod method, const std::function<void()>& done = nullptr);
+
+    /**
+     * @brief Queued call of any other method on the thread of an integration, e.g. IntegrationInterface::sendCommand.
+     * The integration object must never be called directly, it might run on another thread.
+     * @param call Called with the integration on its thread
+     * @param done Optional, called on the thread of the integration after the call
+     * @return false if the integration is not scheduled, nothing is called then
+     */
+    bool post(const QString& id, const std::function<void(IntegrationInterface*)>& call,
+              const std::function<void()>& done = nullptr);
+
+    /**
+     * @brief Load accounting of the integrations
+     * @return id -> {thread, cpu_time (ms, of the thread), pending_calls, queue_latency (ms, of the last call)}
+     */
+    Q_INVOKABLE QVariantMap statistics();
+
+ private:
+    struct ScheduledIntegration {
+        QObject*               object;
+        IntegrationThread*     thread;  // nullptr on the GUI thread
+        bool                   dedicated;
+        QAtomicInt             pendingCalls;
+        QAtomicInteger<qint64> queueLatency;
+    };
+
+    IntegrationThread* sharedThread();
+    void               stopThread(IntegrationThread* thread);
+
+    QHash<QString, QSharedPointer<ScheduledIntegration>> m_integrations;
+    IntegrationThread*                                   m_sharedThread;
+};
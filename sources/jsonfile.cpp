@@ -23,13 +23,23 @@
 
 #include "jsonfile.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonDocument>
 #include <QLoggingCategory>
+#include <QMutex>
+#include <QSaveFile>
 #include <QUrl>
 #include <QtDebug>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <iostream>
 #include <string>
 
@@ -50,6 +60,14 @@ using valijson::adapters::QtJsonAdapter;
 
 static Q_LOGGING_CATEGORY(CLASS_LC, "json");
 
+// Compiled schemas shared by all JsonFile instances. Key: schema path and optional top level property.
+struct CachedSchema {
+    QDateTime                    lastModified;
+    QSharedPointer<const Schema> schema;
+};
+static QHash<QString, CachedSchema> s_schemaCache;
+static QMutex                       s_schemaCacheMutex;
+
 JsonFile::JsonFile(QObject *parent) : QObject(parent) {}
 
 JsonFile::JsonFile(const QString &path, const QString &schemaPath, QObject *parent)
@@ -73,7 +91,7 @@ bool JsonFile::rename(const QString &newName) {
     return success;
 }
 
-bool JsonFile::write(const QVariantMap &data) {
+bool JsonFile::write(const QVariantMap &data, bool validate) {
     m_error.clear();
     if (m_file.fileName().isEmpty()) {
         qCWarning(CLASS_LC) << "Not writing json file: no filename set!";
@@ -87,29 +105,64 @@ bool JsonFile::write(const QVariantMap &data) {
         return false;
     }
 
-    if (!validate(doc, m_error)) {
+    if (validate && !this->validate(doc, m_error)) {
         qCWarning(CLASS_LC) << "JSON document failed schema validation before writing:" << m_file.fileName();
         return false;
     }
 
     QByteArray json = doc.toJson();
-    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
-        m_error = tr("cannot open file '%1' for writing: %2").arg(m_file.fileName()).arg((m_file.errorString()));
+
+    // QSaveFile writes to a temporary file, syncs it to disk and renames it over the original file on commit.
+    // A power loss during writing leaves either the old or the new file, but never a truncated one.
+    QSaveFile file(m_file.fileName());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_error = tr("cannot open file '%1' for writing: %2").arg(file.fileName()).arg((file.errorString()));
         qCWarning(CLASS_LC) << m_error;
         return false;
     }
-    bool success = m_file.write(json) == json.size();
-    m_file.close();
-    return success;
+    if (file.write(json) != json.size() || !file.commit()) {
+        m_error = tr("cannot write file '%1': %2").arg(file.fileName()).arg((file.errorString()));
+        qCWarning(CLASS_LC) << m_error;
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    // make sure the rename is persisted as well
+    int dirFd = ::open(QFileInfo(m_file).absolutePath().toLocal8Bit().constData(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+
+    if (m_checksumEnabled) {
+        QSaveFile checksumFile(checksumFileName());
+        if (!checksumFile.open(QIODevice::WriteOnly) || checksumFile.write(calculateChecksum(json)) < 0 ||
+            !checksumFile.commit()) {
+            qCWarning(CLASS_LC) << "Cannot write checksum file" << checksumFile.fileName()
+                                << checksumFile.errorString();
+        }
+    }
+
+    return true;
 }
 
 QVariant JsonFile::read() {
     m_error.clear();
     QJsonDocument doc;
-    if (!loadDocument(m_file.fileName(), doc)) {
+    QByteArray    checksum;
+    if (!loadDocument(m_file.fileName(), doc, m_checksumEnabled ? &checksum : nullptr)) {
         return QVariant();
     }
 
+    if (m_checksumEnabled) {
+        QFile checksumFile(checksumFileName());
+        if (checksumFile.open(QIODevice::ReadOnly) && checksumFile.readAll() == checksum) {
+            qCDebug(CLASS_LC) << "Skipping json document schema validation: checksum matches" << m_file.fileName();
+            return doc.toVariant();
+        }
+    }
+
     if (!validate(doc, m_error)) {
         qCWarning(CLASS_LC) << "Read JSON document failed schema validation:" << m_file.fileName();
         // FIXME decide on how to handle errors:
@@ -123,7 +176,7 @@ QVariant JsonFile::read() {
     return doc.toVariant();
 }
 
-bool JsonFile::loadDocument(const QString &path, QJsonDocument &doc) {
+bool JsonFile::loadDocument(const QString &path, QJsonDocument &doc, QByteArray *checksum) {
     if (path.isEmpty()) {
         qCWarning(CLASS_LC) << "Cannot load json file: no filename set!";
         m_error = tr("empty name");
@@ -147,22 +200,93 @@ bool JsonFile::loadDocument(const QString &path, QJsonDocument &doc) {
         return false;
     }
 
+    if (checksum) {
+        *checksum = calculateChecksum(json);
+    }
+
     return true;
 }
 
+QByteArray JsonFile::calculateChecksum(const QByteArray &json) const {
+    // include the schema file modification time: a changed schema requires a new validation
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(json);
+    if (!m_schemaPath.isEmpty()) {
+        hash.addData(QFileInfo(m_schemaPath).lastModified().toString(Qt::ISODateWithMs).toUtf8());
+    }
+    return hash.result().toHex();
+}
+
 bool JsonFile::validate(const QJsonDocument &doc, QString &errorText) {
     if (m_schemaPath.isEmpty()) {
         qCDebug(CLASS_LC) << "Skipping json document schema validation: no schema file set";
         return true;
     }
 
-    // TODO(zehnm) in case there are too many read or write calls we should probably cache the schema document
+    QSharedPointer<const Schema> schema;
+    if (!loadSchema(QString(), schema)) {
+        return false;
+    }
+
+    return JsonFile::validate(
+        doc.isObject() ? QJsonValue(doc.object()) : doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(), *schema,
+        errorText);
+}
+
+bool JsonFile::validateProperty(const QString &property, const QJsonValue &value, QString &errorText) {
+    if (m_schemaPath.isEmpty()) {
+        qCDebug(CLASS_LC) << "Skipping json property schema validation: no schema file set";
+        return true;
+    }
+
+    QSharedPointer<const Schema> schema;
+    if (!loadSchema(property, schema)) {
+        return false;
+    }
+    if (schema.isNull()) {
+        qCDebug(CLASS_LC) << "Skipping json property schema validation: no schema defined for" << property;
+        return true;
+    }
+
+    return JsonFile::validate(value, *schema, errorText);
+}
+
+bool JsonFile::loadSchema(const QString &property, QSharedPointer<const Schema> &schema) {
+    QDateTime lastModified = QFileInfo(m_schemaPath).lastModified();
+    QString   key          = property.isEmpty() ? m_schemaPath : m_schemaPath + "#" + property;
+
+    QMutexLocker locker(&s_schemaCacheMutex);
+
+    auto cached = s_schemaCache.constFind(key);
+    if (cached != s_schemaCache.constEnd() && cached->lastModified == lastModified) {
+        schema = cached->schema;
+        return true;
+    }
+
     QJsonDocument schemaDoc;
     if (!loadDocument(m_schemaPath, schemaDoc)) {
         return false;
     }
 
-    return JsonFile::validate(doc, schemaDoc, errorText);
+    QJsonObject schemaObj = schemaDoc.object();
+    if (!property.isEmpty()) {
+        QJsonObject properties = schemaObj.value("properties").toObject();
+        schemaObj              = properties.value(property).toObject();
+    }
+
+    // Parse JSON schema content using valijson
+    QSharedPointer<Schema> parsedSchema;
+    if (property.isEmpty() || !schemaObj.isEmpty()) {
+        parsedSchema = QSharedPointer<Schema>::create();
+        SchemaParser  parser;
+        QtJsonAdapter schemaAdapter(schemaObj);
+        parser.populateSchema(schemaAdapter, *parsedSchema);
+    }
+
+    qCDebug(CLASS_LC) << "Loaded json schema into cache:" << key;
+    s_schemaCache.insert(key, {lastModified, parsedSchema});
+    schema = parsedSchema;
+    return true;
 }
 
 bool JsonFile::validate(const QJsonDocument &doc, const QJsonDocument &schemaDoc, QString &errorText) {
@@ -172,11 +296,16 @@ bool JsonFile::validate(const QJsonDocument &doc, const QJsonDocument &schemaDoc
     QtJsonAdapter schemaAdapter(schemaDoc.object());
     parser.populateSchema(schemaAdapter, schema);
 
+    return JsonFile::validate(
+        doc.isObject() ? QJsonValue(doc.object()) : doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(), schema,
+        errorText);
+}
+
+bool JsonFile::validate(const QJsonValue &value, const Schema &schema, QString &errorText) {
     // Perform validation
     Validator         validator;
     ValidationResults results;
-    QtJsonAdapter     targetDocumentAdapter(doc.isObject() ? QJsonValue(doc.object())
-                                                       : doc.isArray() ? QJsonValue(doc.array()) : QJsonValue());
+    QtJsonAdapter     targetDocumentAdapter(value);
     if (!validator.validate(schema, targetDocumentAdapter, &results)) {
         std::ostringstream err;
         err << "Validation failed." << endl;
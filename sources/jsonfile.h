@@ -25,8 +25,13 @@
 
 #include <QFile>
 #include <QObject>
+#include <QSharedPointer>
 #include <QVariant>
 
+namespace valijson {
+class Schema;
+}
+
 class JsonFile : public QObject {
     Q_OBJECT
 
@@ -70,7 +75,21 @@ class JsonFile : public QObject {
     }
     Q_INVOKABLE inline bool remove() { return m_file.remove(); }
 
-    Q_INVOKABLE bool     write(const QVariantMap &data);
+    /**
+     * @brief setChecksumEnabled Enables a checksum file next to the JSON file. The checksum file is written after each
+     * successful write and allows read() to skip the schema validation if the file wasn't changed in between.
+     */
+    inline void setChecksumEnabled(bool enabled) { m_checksumEnabled = enabled; }
+
+    /**
+     * @brief write Writes the data as JSON document to the file.
+     * The file is replaced atomically: the data is written and synced to a temporary file which is then renamed.
+     * @param data The data to write
+     * @param validate Validate the data against the associated schema before writing. Only disable validation if the
+     * data has already been validated, e.g. with validateProperty.
+     * @return true if successful
+     */
+    Q_INVOKABLE bool     write(const QVariantMap &data, bool validate = true);
     Q_INVOKABLE QVariant read();
 
     /**
@@ -91,6 +110,17 @@ class JsonFile : public QObject {
     static bool validate(const QJsonDocument &doc, const QJsonDocument &schema,
                          QString &errorText);  // NOLINT we do not want a pointer for errorText
 
+    /**
+     * @brief validateProperty Validates a single top level property against its sub-schema in the associated schema
+     * of the JsonFile instance. This is much cheaper than validating the complete document if only one part changed.
+     * @param property The name of the top level property
+     * @param value The new value of the property
+     * @param errorText Returns the validation error text
+     * @return true if the value is valid according to the property schema, or if the schema doesn't define the property
+     */
+    bool validateProperty(const QString &property, const QJsonValue &value,
+                          QString &errorText);  // NOLINT we do not want a pointer for errorText
+
  signals:
     void nameChanged(const QString &name);
 
@@ -102,9 +132,27 @@ class JsonFile : public QObject {
     void setName(const QString &name);
 
  private:
-    bool loadDocument(const QString &path, QJsonDocument &doc);  // NOLINT we do not want a pointer for doc
+    bool loadDocument(const QString &path, QJsonDocument &doc,  // NOLINT we do not want a pointer for doc
+                      QByteArray *checksum = nullptr);
+
+    QByteArray calculateChecksum(const QByteArray &json) const;
+    QString    checksumFileName() const { return m_file.fileName() + ".checksum"; }
+
+    /**
+     * @brief loadSchema Returns the compiled schema of the associated schema file from the shared schema cache.
+     * The schema file is only loaded and parsed again if its modification time changed.
+     * @param property Optional top level property to return the sub-schema for. Empty for the complete schema.
+     * @param schema Returns the compiled schema, or a null pointer if the schema doesn't define the property
+     * @return false if the schema file could not be loaded
+     */
+    bool loadSchema(const QString &property,
+                    QSharedPointer<const valijson::Schema> &schema);  // NOLINT we do not want a pointer for schema
+
+    static bool validate(const QJsonValue &value, const valijson::Schema &schema,
+                         QString &errorText);  // NOLINT we do not want a pointer for errorText
 
     QFile   m_file;
     QString m_schemaPath;
     QString m_error;
+    bool    m_checksumEnabled = false;
 };
@@ -22,14 +22,6 @@
 
 #include "launcher.h"
 
-#include <QLoggingCategory>
-#include <QPluginLoader>
-#include <QtDebug>
-
-#include "notifications.h"
-
-static Q_LOGGING_CATEGORY(CLASS_LC, "plugin");
-
 Launcher::Launcher(QObject *parent) : QObject(parent), m_process(new QProcess(this)) {}
 
 QString Launcher::launch(const QString &program) {
@@ -40,22 +32,6 @@ QString Launcher::launch(const QString &program) {
     return output;
 }
 
-QObject *Launcher::loadPlugin(const QString &path, const QString &pluginName) {
-    QString       pluginPath = getPluginPath(path, pluginName);
-    QPluginLoader pluginLoader(pluginPath, this);
-
-    QJsonObject metaData = pluginLoader.metaData()["MetaData"].toObject();
-    qCInfo(CLASS_LC) << "LOADING PLUGIN:" << pluginPath << "version:" << metaData["version"].toString();
-
-    QObject *plugin = pluginLoader.instance();
-    if (!plugin) {
-        qCCritical(CLASS_LC) << "FAILED TO LOAD PLUGIN: " << pluginPath << pluginLoader.errorString();
-        Notifications::getInstance()->add(true, "Failed to load " + QString(pluginName));
-    }
-
-    return plugin;
-}
-
 QString Launcher::getPluginPath(const QString &path, const QString &pluginName) {
     QString pluginPath;
 #ifdef __arm__
@@ -30,8 +30,7 @@ class Launcher : public QObject {
     explicit Launcher(QObject *parent = nullptr);
     Q_INVOKABLE QString launch(const QString &program);
 
-    QObject *loadPlugin(const QString &path, const QString &pluginName);
-    QString  getPluginPath(const QString &path, const QString &pluginName);
+    static QString getPluginPath(const QString &path, const QString &pluginName);
 
  private:
     QProcess *m_process;
@@ -23,23 +23,86 @@
 #include "logger.h"
 
 #include <QDir>
+#include <QReadLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWriteLocker>
 #include <iostream>
 
+/**
+ * @brief Queries the binary log files on the thread pool, a query of many segments takes too long for the GUI thread.
+ * The messages are handed to the callback with a queued call on the logger.
+ */
+class LogQueryTask : public QRunnable {
+ public:
+    LogQueryTask(Logger* logger, const QString& directory, qint64 from, qint64 to, int logLevelMask,
+                 const QStringList& categories, int maxCount, const QPointer<QObject>& context,
+                 const std::function<void(const QJsonArray&)>& callback)
+        : m_logger(logger),
+          m_directory(directory),
+          m_from(from),
+          m_to(to),
+          m_logLevelMask(logLevelMask),
+          m_categories(categories),
+          m_maxCount(maxCount),
+          m_context(context),
+          m_callback(callback) {}
+
+    void run() override {
+        QJsonArray logs = BinaryLog::query(m_directory, m_from, m_to, m_logLevelMask, m_categories, m_maxCount);
+
+        QPointer<QObject>                      context = m_context;
+        std::function<void(const QJsonArray&)> callback = m_callback;
+        QMetaObject::invokeMethod(m_logger,
+                                  [=]() {
+                                      if (context) {
+                                          callback(logs);
+                                      }
+                                  },
+                                  Qt::QueuedConnection);
+    }
+
+ private:
+    Logger*                                m_logger;
+    QString                                m_directory;
+    qint64                                 m_from;
+    qint64                                 m_to;
+    int                                    m_logLevelMask;
+    QStringList                            m_categories;
+    int                                    m_maxCount;
+    QPointer<QObject>                      m_context;
+    std::function<void(const QJsonArray&)> m_callback;
+};
+
 Logger*     Logger::s_instance = nullptr;
 QStringList Logger::s_msgTypeString = {"DEBUG", "WARN ", "CRIT ", "FATAL", "INFO "};  // parallel to QMsgType
 QtMsgType   Logger::s_msgTypeSorted[] = {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg,
                                        QtFatalMsg};  // sorted by severity
+QLoggingCategory::CategoryFilter Logger::s_previousFilter = nullptr;
 
 Logger::Logger(const QString& path, QString logLevel, bool console, bool showSource, int queueSize, int purgeHours,
-               QObject* parent)
+               bool binary, QObject* parent)
     : QObject(parent),
+      m_logLevel(QtDebugMsg),
+      m_logLevelMask(logLevelToMask(QtDebugMsg)),
       m_consoleEnabled(console),
       m_fileEnabled(path.length() > 0),
+      m_binaryEnabled(binary),
       m_queueEnabled(false),
       m_showSource(showSource),
+      m_lastHour(-1),
       m_maxQueueSize(queueSize),
       m_directory(path),
-      m_file(nullptr) {
+      m_file(nullptr),
+      m_binaryLog(nullptr),
+      m_buffer(BUFFER_SIZE),
+      m_dropped(0),
+      m_writeRequested(WRITE_NONE),
+      m_writer(new QObject()),
+      m_flushTimer(new QTimer(m_writer)),
+      m_stream(STREAM_SIZE),
+      m_streamHead(0),
+      m_streamEnabled(0) {
     s_instance = this;
 
     Q_ASSERT(s_msgTypeString.length() == QtMsgType::QtInfoMsg + 1);
@@ -48,21 +111,38 @@ Logger::Logger(const QString& path, QString logLevel, bool console, bool showSou
         QDir().mkdir(m_directory);
     }
 
+    // formatting and writing is done on the writer thread, in batches
+    // the flush timer is only armed when a message enters an empty buffer
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(m_flushTimer, &QTimer::timeout, m_writer, [=]() { writePending(); });
+    m_writer->moveToThread(&m_writerThread);
+    m_writerThread.setObjectName("logger");
+    m_writerThread.start(QThread::LowPriority);
+
     qInstallMessageHandler(&messageOutput);
     defineLogCategory("default", QtMsgType::QtInfoMsg, QLoggingCategory::defaultCategory());
     if (!logLevel.isEmpty()) {
         setLogLevel(static_cast<QtMsgType>(toMsgType(logLevel)));
     }
+    updateCategoryFilter();
 
     if (m_fileEnabled) {
         purgeFiles(purgeHours);
     }
 }
 Logger::~Logger() {
+    s_instance = nullptr;
+    QLoggingCategory::installFilter(s_previousFilter);
+    flush();
+    m_writerThread.quit();
+    m_writerThread.wait();
+    delete m_writer;
     if (m_file != nullptr) {
         m_file->close();
+        delete m_file;
     }
-    s_instance = nullptr;
+    delete m_binaryLog;
 }
 
 int Logger::toMsgType(const QString& msgType) {
@@ -79,6 +159,7 @@ void Logger::setLogLevel(int logLevel) {
     QtMsgType level = static_cast<QtMsgType>(logLevel);
     m_logLevel = level;
     m_logLevelMask = logLevelToMask(level);
+    updateCategoryFilter();
 }
 
 void Logger::setCategoryLogLevel(const QString& category, int logLevel) {
@@ -88,45 +169,113 @@ void Logger::setCategoryLogLevel(const QString& category, int logLevel) {
 void Logger::defineLogCategory(const QString& category, int level, QLoggingCategory* loggingCategory,
                                PluginInterface* plugin) {
     QtMsgType  logLevel = static_cast<QtMsgType>(level);
-    SCategory* cat = m_categories.value(category);
-    if (cat == nullptr) {
-        // Add new category
-        cat = new SCategory(logLevel, loggingCategory, plugin);
-        m_categories.insert(category, cat);
-        qInfo() << "Create logging category" << category << "Level : " << s_msgTypeString[level];
-    } else {
-        if (cat->logLevel != logLevel) {
-            qInfo() << "Set logging category" << category << "Level : " << s_msgTypeString[level];
+    SCategory* cat;
+    bool       created = false;
+    bool       changed = false;
+    {
+        QWriteLocker lock(&m_categoriesLock);
+        cat = m_categories.value(category);
+        if (cat == nullptr) {
+            // Add new category
+            cat = new SCategory(category, logLevel, true, loggingCategory, plugin);
+            m_categories.insert(category, cat);
+            created = true;
+        } else {
+            changed = cat->logLevel != logLevel || !cat->defined;
             cat->logLevel = logLevel;
-            cat->logLevelMask = logLevelToMask(logLevel);
+            cat->logLevelMask.store(logLevelToMask(logLevel));
+            cat->defined = true;
+            if (loggingCategory != nullptr) {
+                cat->logCategory = loggingCategory;
+            }
+            if (plugin != nullptr) {
+                cat->plugin = plugin;
+            }
         }
     }
-    bool enable = false;
-    int  size = sizeof(s_msgTypeSorted) / sizeof(s_msgTypeSorted[0]);
-    for (int i = 0; i < size; i++) {
-        QtMsgType thisLevel = s_msgTypeSorted[i];
-        if (logLevel == thisLevel) {
-            enable = true;
-        }
-        if (cat->logCategory != nullptr) {
-            cat->logCategory->setEnabled(thisLevel, enable);
-        }
-        if (cat->plugin != nullptr) {
+    if (created) {
+        qInfo() << "Create logging category" << category << "Level : " << s_msgTypeString[level];
+    } else if (changed) {
+        qInfo() << "Set logging category" << category << "Level : " << s_msgTypeString[level];
+    }
+
+    // the QLoggingCategory objects get their enabled flags from categoryFilter
+    updateCategoryFilter();
+    if (cat->plugin != nullptr) {
+        bool enable = false;
+        int  size = sizeof(s_msgTypeSorted) / sizeof(s_msgTypeSorted[0]);
+        for (int i = 0; i < size; i++) {
+            QtMsgType thisLevel = s_msgTypeSorted[i];
+            if (logLevel == thisLevel) {
+                enable = true;
+            }
             cat->plugin->setLogEnabled(thisLevel, enable);
         }
     }
 }
 void Logger::removeCategory(const QString& category) {
-    if (m_categories.contains(category)) {
-        m_categories.remove(category);
+    // the category object is not deleted, messages of other threads may still refer to it
+    QWriteLocker lock(&m_categoriesLock);
+    SCategory*   cat = m_categories.take(category);
+    if (cat != nullptr) {
+        for (auto iter = m_categoriesByName.begin(); iter != m_categoriesByName.end();) {
+            iter = iter.value() == cat ? m_categoriesByName.erase(iter) : iter + 1;
+        }
     }
 }
 
 int Logger::getCategoryLogLevel(const QString& category) {
-    SCategory* cat = m_categories.value(category);
+    QReadLocker lock(&m_categoriesLock);
+    SCategory*  cat = m_categories.value(category);
     return (cat == nullptr) ? m_logLevel : cat->logLevel;
 }
 
+Logger::SCategory* Logger::category(const char* name) {
+    {
+        QReadLocker lock(&m_categoriesLock);
+        SCategory*  cat = m_categoriesByName.value(name);
+        if (cat != nullptr) {
+            return cat;
+        }
+    }
+    QWriteLocker lock(&m_categoriesLock);
+    QString      categoryName = QString::fromUtf8(name);
+    SCategory*   cat = m_categories.value(categoryName);
+    if (cat == nullptr) {
+        // Add new category, initialized with overall log level
+        cat = new SCategory(categoryName, m_logLevel, false);
+        m_categories.insert(categoryName, cat);
+    }
+    m_categoriesByName.insert(name, cat);
+    return cat;
+}
+
+void Logger::categoryFilter(QLoggingCategory* category) {
+    // Qt logging rules first, they apply to the categories without a defined log level
+    if (s_previousFilter != nullptr) {
+        s_previousFilter(category);
+    }
+    if (s_instance == nullptr) {
+        return;
+    }
+    SCategory* cat = s_instance->category(category->categoryName());
+    int        mask = cat->defined ? cat->logLevelMask.load() : s_instance->m_logLevelMask;
+    int        size = sizeof(s_msgTypeSorted) / sizeof(s_msgTypeSorted[0]);
+    for (int i = 0; i < size; i++) {
+        QtMsgType type = s_msgTypeSorted[i];
+        bool      enable = (mask & (1 << type)) != 0;
+        category->setEnabled(type, cat->defined ? enable : enable && category->isEnabled(type));
+    }
+}
+
+void Logger::updateCategoryFilter() {
+    // installing the filter applies it to all existing categories
+    QLoggingCategory::CategoryFilter previous = QLoggingCategory::installFilter(&categoryFilter);
+    if (previous != &categoryFilter) {
+        s_previousFilter = previous;
+    }
+}
+
 quint16 Logger::logLevelToMask(QtMsgType logLevel) {
     int     size = sizeof(s_msgTypeSorted) / sizeof(s_msgTypeSorted[0]);
     bool    enable = false;
@@ -136,7 +285,7 @@ quint16 Logger::logLevelToMask(QtMsgType logLevel) {
             enable = true;
         }
         if (enable) {
-            mask |= (1 << i);
+            mask |= (1 << s_msgTypeSorted[i]);  // bit by QtMsgType, as tested in processMessage
         }
     }
     return mask;
@@ -144,62 +293,166 @@ quint16 Logger::logLevelToMask(QtMsgType logLevel) {
 
 void Logger::processMessage(QtMsgType type, const char* category, const char* source, int line, const QString& msg,
                             bool writeanyHow) {
-    QString    cat = category == nullptr ? "default" : category;
-    SCategory* c = m_categories.value(cat);
-    if (c == nullptr) {
-        // Add new category
-        c = new SCategory(m_logLevel);  // Initialize with overall log level
-        m_categories.insert(cat, c);
-    }
+    SCategory* c = this->category(category == nullptr ? "default" : category);
     Q_ASSERT(type <= QtMsgType::QtInfoMsg);
-    c->count[type]++;
+    c->count[type].ref();
     // if overall or category specific is enabled
-    if (writeanyHow || !!((m_logLevelMask | c->logLevelMask) & (1 << type))) {
+    if (writeanyHow || !!((m_logLevelMask | c->logLevelMask.load()) & (1 << type))) {
+        quint8 targets = (m_consoleEnabled ? TARGET_CONSOLE : 0) |
+                         (m_fileEnabled ? (m_binaryEnabled ? TARGET_BINARY : TARGET_FILE) : 0) |
+                         (m_queueEnabled ? TARGET_QUEUE : 0) | (m_streamEnabled.load() ? TARGET_STREAM : 0);
+        if (targets == 0) {
+            return;
+        }
         QString sourcePosition;
         if (m_showSource && source != nullptr) {
-            sourcePosition = QString("%1:%2").arg(source).arg(line);
+            sourcePosition = QString::fromUtf8(source) + ':' + QString::number(line);
         }
-        QDateTime dt = QDateTime::currentDateTimeUtc();
-        SMessage  message(type, dt.toTime_t(), cat, msg, sourcePosition);
-        if (m_consoleEnabled) {
-            writeConsole(message);
+        SMessage message(type, QDateTime::currentMSecsSinceEpoch(), c->name, msg, sourcePosition, targets);
+        if (!m_buffer.push(std::move(message))) {
+            m_dropped.ref();
         }
-        if (m_fileEnabled) {
-            writeFile(message, dt);
-        }
-        if (m_queueEnabled) {
-            writeQueue(message);
+
+        if (type == QtFatalMsg) {
+            // the application is aborted after the message handler returns
+            flush();
+        } else if (type != QtDebugMsg && type != QtInfoMsg) {
+            if (m_writeRequested.fetchAndStoreOrdered(WRITE_NOW) != WRITE_NOW) {
+                QMetaObject::invokeMethod(m_writer, [=]() { writePending(); }, Qt::QueuedConnection);
+            }
+        } else if (m_writeRequested.testAndSetOrdered(WRITE_NONE, WRITE_DELAYED)) {
+            QMetaObject::invokeMethod(m_writer, [=]() { m_flushTimer->start(); }, Qt::QueuedConnection);
         }
     }
 }
 
+void Logger::flush() {
+    if (QThread::currentThread() == &m_writerThread) {
+        writePending();
+    } else if (m_writerThread.isRunning()) {
+        QMetaObject::invokeMethod(m_writer, [=]() { writePending(); }, Qt::BlockingQueuedConnection);
+    }
+}
+
 void Logger::messageOutput(::QtMsgType type, const QMessageLogContext& context, const QString& msg) {
     if (s_instance != nullptr) {
         s_instance->processMessage(type, context.category, context.file, context.line, msg);
     }
 }
 
-void Logger::writeFile(const SMessage& message, const QDateTime& dt) {
-    int hour = dt.time().hour();
-    if (hour != m_lastHour || m_file == nullptr) {
-        m_lastHour = hour;
-        if (m_file != nullptr) {
-            m_file->close();
+void Logger::writePending() {
+    m_flushTimer->stop();
+    m_writeRequested.store(WRITE_NONE);
+
+    QByteArray           console;
+    QByteArray           lines;
+    QVector<StreamEntry> stream;
+    SMessage             message;
+    while (m_buffer.pop(message)) {
+        if (message.targets & TARGET_FILE) {
+            // hourly rotation, the lines of the previous hour go to the previous file
+            QDateTime dt   = QDateTime::fromMSecsSinceEpoch(message.timestamp, Qt::UTC);
+            qint64    hour = message.timestamp / 3600000;
+            if (hour != m_lastHour || m_file == nullptr) {
+                writeFile(lines);
+                lines.clear();
+                m_lastHour = hour;
+                if (m_file != nullptr) {
+                    m_file->close();
+                    delete m_file;
+                }
+                m_file = new QFile(QString("%1/%2.log").arg(m_directory, dt.toString("yyyy-MM-dd-hh")));
+                m_file->open(QIODevice::Append | QIODevice::Text);
+            }
+            lines += (dt.toString("dd.MM.yyyy hh:mm:ss") + ' ' + s_msgTypeString[message.type] + ' ' +
+                      message.category + ' ' + message.message + ' ' + message.sourcePosition + '\n')
+                         .toUtf8();
+        }
+        if (message.targets & TARGET_BINARY) {
+            if (m_binaryLog == nullptr) {
+                m_binaryLog = new BinaryLog(m_directory);
+            }
+            m_binaryLog->append(message.timestamp, message.type, message.category, message.sourcePosition,
+                                message.message);
+        }
+        if (message.targets & TARGET_CONSOLE) {
+            console += (s_msgTypeString[message.type] + ' ' + message.category + ' ' + message.message + ' ' +
+                        message.sourcePosition + '\n')
+                           .toUtf8();
+        }
+        if (message.targets & TARGET_QUEUE) {
+            writeQueue(message);
+        }
+        if (message.targets & TARGET_STREAM) {
+            stream.append({0, message.type, message.timestamp, message.category, message.message,
+                           message.sourcePosition});
+        }
+    }
+
+    int dropped = m_dropped.fetchAndStoreRelaxed(0);
+    if (dropped > 0) {
+        QByteArray line = QByteArray::number(dropped) + " log messages dropped\n";
+        console += line;
+        lines += line;
+        if (m_binaryLog != nullptr) {
+            m_binaryLog->append(QDateTime::currentMSecsSinceEpoch(), QtWarningMsg, "default", QString(),
+                                QString::fromUtf8(line.trimmed()));
+        }
+    }
+
+    writeFile(lines);
+    if (m_binaryLog != nullptr) {
+        m_binaryLog->flush();
+    }
+    writeStream(&stream);
+    if (!console.isEmpty()) {
+        std::cout.write(console.constData(), console.size());  // goes to console
+        std::cout.flush();
+    }
+}
+
+void Logger::writeFile(const QByteArray& lines) {
+    if (!lines.isEmpty() && m_file != nullptr && m_file->isOpen()) {
+        m_file->write(lines);
+        m_file->flush();
+    }
+}
+
+void Logger::writeStream(QVector<StreamEntry>* entries) {
+    if (entries->isEmpty()) {
+        return;
+    }
+    {
+        QMutexLocker lock(&m_streamMutex);
+        for (StreamEntry& entry : *entries) {
+            entry.sequence = m_streamHead++;
+            m_stream[static_cast<int>(entry.sequence % STREAM_SIZE)] = std::move(entry);
         }
-        m_file = new QFile;
-        QString path = QString("%1/%2.log").arg(m_directory, dt.toString("yyyy-MM-dd-hh"));
-        m_file->setFileName(path);
-        m_file->open(QIODevice::Append | QIODevice::Text);
-    }
-    QString msg = QString("%1 %2 %3 %4 %5")
-                      .arg(dt.toString("dd.MM.yyyy hh:mm:ss"))
-                      .arg(s_msgTypeString[message.type])
-                      .arg(message.category)
-                      .arg(message.message)
-                      .arg(message.sourcePosition);
-    QTextStream out(m_file);
-    out.setCodec("UTF-8");
-    out << msg << endl;
+    }
+    emit streamAvailable();
+}
+
+quint64 Logger::streamHead() {
+    QMutexLocker lock(&m_streamMutex);
+    return m_streamHead;
+}
+
+quint64 Logger::readStream(quint64* cursor, int maxCount, int logLevel, const QSet<QString>& categories,
+                           QVector<StreamEntry>* entries) {
+    quint16      levelMask = logLevelToMask(static_cast<QtMsgType>(logLevel));
+    quint64      lost = 0;
+    QMutexLocker lock(&m_streamMutex);
+    if (m_streamHead - *cursor > STREAM_SIZE) {
+        lost = m_streamHead - STREAM_SIZE - *cursor;
+        *cursor = m_streamHead - STREAM_SIZE;
+    }
+    for (; *cursor < m_streamHead && entries->size() < maxCount; ++*cursor) {
+        const StreamEntry& entry = m_stream[static_cast<int>(*cursor % STREAM_SIZE)];
+        if ((levelMask & (1 << entry.type)) && (categories.isEmpty() || categories.contains(entry.category))) {
+            entries->append(entry);
+        }
+    }
+    return lost;
 }
 
 void Logger::writeQueue(const SMessage& message) {
@@ -210,16 +463,6 @@ void Logger::writeQueue(const SMessage& message) {
     m_queue.enqueue(message);
 }
 
-void Logger::writeConsole(const SMessage &message) {
-    QString msg = QString("%1 %2 %3 %4\n")
-                      .arg(s_msgTypeString[message.type])
-                      .arg(message.category)
-                      .arg(message.message)
-                      .arg(message.sourcePosition);
-    std::cout << msg.toStdString();  // goes to console
-    std::cout.flush();
-}
-
 void Logger::write(const QString& msg) { processMessage(QtMsgType::QtInfoMsg, "default", nullptr, 0, msg, true); }
 void Logger::writeDebug(const QString& msg) { processMessage(QtMsgType::QtDebugMsg, "default", nullptr, 0, msg, true); }
 void Logger::writeInfo(const QString& msg) { processMessage(QtMsgType::QtInfoMsg, "default", nullptr, 0, msg, true); }
@@ -227,14 +470,18 @@ void Logger::writeWarning(const QString& msg) {
     processMessage(QtMsgType::QtWarningMsg, "default", nullptr, 0, msg, true);
 }
 void Logger::purgeFiles(int purgeHours) {
+    QMetaObject::invokeMethod(m_writer, [=]() { removeFiles(purgeHours); }, Qt::QueuedConnection);
+}
+void Logger::removeFiles(int purgeHours) {
     QDir      dir(m_directory);
     QDateTime dt = QDateTime::currentDateTime();
     dt = dt.addSecs(-purgeHours * 3600);
-    QStringList fileNames = dir.entryList(QStringList("*.log"), QDir::Files);
+    QStringList fileNames = dir.entryList(
+        QStringList({"*.log", BinaryLog::FILE_PATTERN, BinaryLog::INDEX_PATTERN}), QDir::Files);
     int         count = 0;
     for (QStringList::iterator i = fileNames.begin(); i != fileNames.end(); ++i) {
         try {
-            int idx = i->lastIndexOf('.');
+            int idx = i->indexOf('.');
             if (idx > 0) {
                 QDateTime filedt = QDateTime::fromString(i->left(idx), "yyyy-MM-dd-HH");
                 if (filedt < dt) {
@@ -252,7 +499,7 @@ void Logger::purgeFiles(int purgeHours) {
 }
 int Logger::getFileCount() {
     QDir        dir(m_directory);
-    QStringList fileNames = dir.entryList(QStringList("*.log"), QDir::Files);
+    QStringList fileNames = dir.entryList(QStringList({"*.log", BinaryLog::FILE_PATTERN}), QDir::Files);
     return fileNames.length();
 }
 
@@ -260,6 +507,9 @@ QJsonArray Logger::getQueuedMessages(int maxCount, int logLevel, const QStringLi
     QJsonArray array;
     int        i = 0;
     quint16    levelMask = logLevelToMask(static_cast<QtMsgType>(logLevel));
+
+    // the writer thread enqueues concurrently
+    QMutexLocker lock(&m_queueMutex);
     while (i < maxCount && !m_queue.isEmpty()) {
         SMessage msg = m_queue.dequeue();
         if (!(levelMask & (1 << msg.type))) {
@@ -271,7 +521,7 @@ QJsonArray Logger::getQueuedMessages(int maxCount, int logLevel, const QStringLi
         QJsonObject obj;
         obj.insert("type", msg.type);
         obj.insert("cat", msg.category);
-        obj.insert("time", QString::number(msg.timestamp));
+        obj.insert("time", QString::number(msg.timestamp / 1000));
         obj.insert("msg", msg.message);
         if (!msg.sourcePosition.isEmpty()) {
             obj.insert("src", msg.sourcePosition);
@@ -280,14 +530,50 @@ QJsonArray Logger::getQueuedMessages(int maxCount, int logLevel, const QStringLi
     }
     return array;
 }
+void Logger::getLogs(qint64 from, qint64 to, int logLevel, const QStringList& categories, int maxCount,
+                     QObject* context, const std::function<void(const QJsonArray&)>& callback) {
+    QPointer<QObject> receiver(context);
+    if (!m_fileEnabled) {
+        QMetaObject::invokeMethod(this,
+                                  [=]() {
+                                      if (receiver) {
+                                          callback(QJsonArray());
+                                      }
+                                  },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    int  logLevelMask = logLevelToMask(static_cast<QtMsgType>(logLevel));
+    auto startQuery = [=]() {
+        QThreadPool::globalInstance()->start(
+            new LogQueryTask(this, m_directory, from, to, logLevelMask, categories, maxCount, receiver, callback));
+    };
+    if (!m_writerThread.isRunning()) {
+        startQuery();
+        return;
+    }
+    // the messages of the last flush interval are queried too, with an up to date index
+    QMetaObject::invokeMethod(m_writer,
+                              [=]() {
+                                  writePending();
+                                  if (m_binaryLog != nullptr) {
+                                      m_binaryLog->writeIndex();
+                                  }
+                                  startQuery();
+                              },
+                              Qt::QueuedConnection);
+}
 QJsonObject Logger::getInformation() {
     QJsonObject info;
     info.insert("fileEnabled", m_fileEnabled);
+    info.insert("binaryEnabled", m_binaryEnabled);
     info.insert("queueEnabled", m_queueEnabled);
     info.insert("consoleEnabled", m_consoleEnabled);
     info.insert("fileCount", getFileCount());
     info.insert("showSourcePos", m_showSource);
     QJsonArray                         array;
+    QReadLocker                        lock(&m_categoriesLock);
     QHashIterator<QString, SCategory*> i(m_categories);
     int                                idx = 0;
     while (i.hasNext()) {
@@ -295,11 +581,11 @@ QJsonObject Logger::getInformation() {
         QJsonObject obj;
         obj.insert("category", i.key());
         obj.insert("level", i.value()->logLevel);
-        obj.insert("countDebug", i.value()->count[QtMsgType::QtDebugMsg]);
-        obj.insert("countInfo", i.value()->count[QtMsgType::QtInfoMsg]);
-        obj.insert("countCritical", i.value()->count[QtMsgType::QtCriticalMsg]);
-        obj.insert("countWarning", i.value()->count[QtMsgType::QtWarningMsg]);
-        obj.insert("countFatal", i.value()->count[QtMsgType::QtFatalMsg]);
+        obj.insert("countDebug", i.value()->count[QtMsgType::QtDebugMsg].load());
+        obj.insert("countInfo", i.value()->count[QtMsgType::QtInfoMsg].load());
+        obj.insert("countCritical", i.value()->count[QtMsgType::QtCriticalMsg].load());
+        obj.insert("countWarning", i.value()->count[QtMsgType::QtWarningMsg].load());
+        obj.insert("countFatal", i.value()->count[QtMsgType::QtFatalMsg].load());
         array.insert(idx++, obj);
     }
     info.insert("categories", array);
@@ -29,9 +29,19 @@
 #include <QLoggingCategory>
 #include <QMutex>
 #include <QObject>
+#include <QPointer>
 #include <QQueue>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
 
+#include <functional>
+
+#include "binarylog.h"
+#include "ringbuffer.h"
 #include "yio-interface/plugininterface.h"
 
 class Logger : public QObject {
@@ -41,6 +51,7 @@ class Logger : public QObject {
     // Unfortunately it is not possible to use QtMsgType as logLevel, using an int
     Q_PROPERTY(int logLevel READ logLevel WRITE setLogLevel)  // default log level
     Q_PROPERTY(bool fileEnabled READ fileEnabled WRITE setFileEnabled)
+    Q_PROPERTY(bool binaryEnabled READ binaryEnabled WRITE setBinaryEnabled)  // binary log files instead of text
     Q_PROPERTY(bool queueEnabled READ queueEnabled WRITE setQueueEnabled)
     Q_PROPERTY(bool consoleEnabled READ consoleEnabled WRITE setConsoleEnabled)
     Q_PROPERTY(bool showSourcePos READ showSourcePos WRITE setShowSourcePos)
@@ -64,8 +75,16 @@ class Logger : public QObject {
     Q_INVOKABLE QJsonArray  getQueuedMessages(int maxCount, int logLevel, const QStringList& categories);
     Q_INVOKABLE QJsonObject getInformation();
 
+    // Query the binary log files on the thread pool, from and to are unix time in ms. The messages are passed to the
+    // callback on the GUI thread, unless the context object was deleted in the meantime.
+    void getLogs(qint64 from, qint64 to, int logLevel, const QStringList& categories, int maxCount, QObject* context,
+                 const std::function<void(const QJsonArray&)>& callback);
+
     Q_INVOKABLE int  getFileCount();
-    Q_INVOKABLE void purgeFiles(int purgeHours);
+    Q_INVOKABLE void purgeFiles(int purgeHours);  // on the writer thread
+
+    // write all pending messages, blocks until they are written
+    Q_INVOKABLE void flush();
 
     // path :       directory for log file, if empty no log file
     // logLevel :   default log level
@@ -73,14 +92,17 @@ class Logger : public QObject {
     // showSource : show qDebug ... source and line
     // queueSize :  maximum Queue size
     // purgeHours : purge at start
+    // binary :     binary log files instead of text files
     explicit Logger(const QString& path, QString logLevel = "DEBUG", bool console = true, bool showSource = false,
-                    int queueSize = 100, int purgeHours = 12, QObject* parent = nullptr);
+                    int queueSize = 100, int purgeHours = 12, bool binary = false, QObject* parent = nullptr);
     ~Logger();
 
     QtMsgType      logLevel() { return m_logLevel; }
     void           setLogLevel(int logLevel);
     bool           fileEnabled() { return m_fileEnabled; }
     void           setFileEnabled(bool value) { m_fileEnabled = value; }
+    bool           binaryEnabled() { return m_binaryEnabled; }
+    void           setBinaryEnabled(bool value) { m_binaryEnabled = value; }
     bool           queueEnabled() { return m_queueEnabled; }
     void           setQueueEnabled(bool value) { m_queueEnabled = value; }
     bool           consoleEnabled() { return m_consoleEnabled; }
@@ -94,54 +116,136 @@ class Logger : public QObject {
     void defineLogCategory(const QString& category, int level, QLoggingCategory* loggingCategory = nullptr,
                            PluginInterface* plugin = nullptr);
 
+    // LIVE LOG STREAM
+    // The writer thread appends the logged messages to a ring buffer, every reader keeps its own cursor into it.
+    static const int STREAM_SIZE = 2048;  // entries of the live log stream
+    struct StreamEntry {
+        quint64   sequence;  // position in the stream
+        QtMsgType type;
+        qint64    timestamp;  // unix time in ms
+        QString   category;
+        QString   message;
+        QString   sourcePosition;
+    };
+
+    // messages are only added to the stream while it is enabled
+    void    setStreamEnabled(bool value) { m_streamEnabled.store(value ? 1 : 0); }
+    quint64 streamHead();
+
+    /**
+     * @brief Copies the stream entries after the cursor, the strings are implicitly shared with the stream
+     * @param cursor Sequence of the next entry to read, advanced past the read entries
+     * @param maxCount Maximum number of entries
+     * @param logLevel Minimum message type
+     * @param categories Requested categories, all if empty
+     * @param entries Receives the matching entries
+     * @return Number of entries which were overwritten before the reader got them
+     */
+    quint64 readStream(quint64* cursor, int maxCount, int logLevel, const QSet<QString>& categories,
+                       QVector<StreamEntry>* entries);
+
+ signals:
+    // new entries were added to the stream, emitted by the writer thread
+    void streamAvailable();
+
  private:
     struct SCategory {
-        explicit SCategory(QtMsgType logLevel, QLoggingCategory* logCategory = nullptr,
-                           PluginInterface* plugin = nullptr)
-            : logCategory(logCategory), plugin(plugin), logLevel(logLevel), logLevelMask(logLevelToMask(logLevel)) {
-            memset(count, 0, sizeof(count));
-        }
+        SCategory(const QString& name, QtMsgType logLevel, bool defined, QLoggingCategory* logCategory = nullptr,
+                  PluginInterface* plugin = nullptr)
+            : name(name),
+              logCategory(logCategory),
+              plugin(plugin),
+              logLevel(logLevel),
+              logLevelMask(logLevelToMask(logLevel)),
+              defined(defined) {}
+        QString           name;                             // category name, shared by all messages
         QLoggingCategory* logCategory;                      // logCategory
         PluginInterface*  plugin;                           // plugin
         QtMsgType         logLevel;                         // !!ored with overall log level
-        quint16           logLevelMask;                     // required because QtMsgType has strange sorting
-        quint16           count[QtMsgType::QtInfoMsg + 1];  // counts errors per msg type
+        QAtomicInt        logLevelMask;                     // bit (1 << QtMsgType) for every enabled type
+        bool              defined;                          // level set with defineLogCategory
+        QAtomicInt        count[QtMsgType::QtInfoMsg + 1];  // counts errors per msg type, from all threads
     };
+    enum Target { TARGET_CONSOLE = 1, TARGET_FILE = 2, TARGET_QUEUE = 4, TARGET_BINARY = 8, TARGET_STREAM = 16 };
     struct SMessage {
-        SMessage(QtMsgType type, uint timestamp, const QString& category, const QString& message,
-                 const QString& sourcePosition)
-            : type(type), timestamp(timestamp), category(category), message(message), sourcePosition(sourcePosition) {}
+        SMessage() : type(QtDebugMsg), timestamp(0), targets(0) {}
+        SMessage(QtMsgType type, qint64 timestamp, const QString& category, const QString& message,
+                 const QString& sourcePosition, quint8 targets)
+            : type(type),
+              timestamp(timestamp),
+              category(category),
+              message(message),
+              sourcePosition(sourcePosition),
+              targets(targets) {}
         QtMsgType type;
-        uint      timestamp;  // unix time
+        qint64    timestamp;  // unix time in ms
         QString   category;
         QString   message;
         QString   sourcePosition;
+        quint8    targets;  // Target flags, decided when the message is logged
     };
 
+    static const int BUFFER_SIZE    = 4096;  // messages between two flushes of the writer thread
+    static const int FLUSH_INTERVAL = 250;   // ms, warnings and errors are flushed immediately
+
+    enum WriteRequest { WRITE_NONE, WRITE_DELAYED, WRITE_NOW };
+
     void processMessage(QtMsgType type, const char* category, const char* source, int line, const QString& msg,
                         bool writeanyHow = false);
-    void writeFile(const SMessage& message, const QDateTime& dt);
+
+    // writer thread: drains the ring buffer and writes the messages in batches
+    void writePending();
+    void writeFile(const QByteArray& lines);
     void writeQueue(const SMessage& message);
-    void writeConsole(const SMessage& message);
+    void writeStream(QVector<StreamEntry>* entries);  // appends the entries of a batch to the stream
+    void removeFiles(int purgeHours);
 
     static void    messageOutput(QtMsgType type, const QMessageLogContext& context, const QString& msg);
     static quint16 logLevelToMask(QtMsgType logLevel);
 
+    // Resolves the category of a message. Categories are cached by the address of their name, which is the same for
+    // all messages of a QLoggingCategory, so a string is only compared the first time a category is seen.
+    SCategory* category(const char* name);
+
+    // Sets the enabled message types of every QLoggingCategory according to the log levels. Disabled messages are
+    // then rejected by the qCDebug... macros with a flag test, before anything is formatted.
+    static void categoryFilter(QLoggingCategory* category);
+    void        updateCategoryFilter();
+
     static Logger*     s_instance;
     static QStringList s_msgTypeString;    // Strings used for logging
     static QtMsgType   s_msgTypeSorted[];  // required because QtMsgType has strange sorting
 
-    QHash<QString, SCategory*> m_categories;  // categories
+    static QLoggingCategory::CategoryFilter s_previousFilter;  // Qt logging rules
+
+    QHash<QString, SCategory*>     m_categories;        // categories
+    QHash<const char*, SCategory*> m_categoriesByName;  // categories by the address of their name
+    QReadWriteLock                 m_categoriesLock;    // categories are resolved from all threads
     QtMsgType                  m_logLevel;    // overall log level
     quint16          m_logLevelMask;          // overall log level mask, required because QtMsgType has strange sorting
     bool             m_consoleEnabled;        // output to console
     bool             m_fileEnabled;           // output to log file
+    bool             m_binaryEnabled;         // log files in binary format
     bool             m_queueEnabled;          // output to queue for JSON API
     bool             m_showSource;            // Show source file and line
-    int              m_lastHour;              // Every hour we create a new file
+    qint64           m_lastHour;              // Every hour we create a new file, hours since epoch
     int              m_maxQueueSize;          // Maximum Queue size
     QString          m_directory;             // For files
     QFile*           m_file;                  // File
+    BinaryLog*       m_binaryLog;             // Binary log files, writer thread
     QQueue<SMessage> m_queue;                 // Queue
     QMutex           m_queueMutex;            // Locking for queue
+
+    // all threads push to the ring buffer, the writer thread formats and writes the messages
+    MpscRingBuffer<SMessage> m_buffer;
+    QAtomicInt               m_dropped;         // messages lost because the ring buffer was full
+    QAtomicInt               m_writeRequested;  // WRITE_DELAYED or WRITE_NOW if a write is already requested
+    QThread                  m_writerThread;
+    QObject*                 m_writer;      // context object of the writer thread
+    QTimer*                  m_flushTimer;  // single shot delayed write, writer thread
+
+    QVector<StreamEntry> m_stream;         // ring buffer, entry of sequence s at s % STREAM_SIZE
+    quint64              m_streamHead;     // sequence of the next entry
+    QMutex               m_streamMutex;    // held by the writer thread only to append a batch
+    QAtomicInt           m_streamEnabled;  // a reader is subscribed
 };
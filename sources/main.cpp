@@ -49,6 +49,7 @@
 #include "softwareupdate.h"
 #include "standbycontrol.h"
 #include "translation.h"
+#include "wakebenchmark.h"
 #include "yioapi.h"
 
 static Q_LOGGING_CATEGORY(CLASS_LC, "main");
@@ -120,7 +121,7 @@ int main(int argc, char* argv[]) {
     }
     Logger logger(path, logCfg.value("level", "WARN").toString(), logCfg.value("console", true).toBool(),
                   logCfg.value("showSource", true).toBool(), logCfg.value("queueSize", 100).toInt(),
-                  logCfg.value("purgeHours", 72).toInt());
+                  logCfg.value("purgeHours", 72).toInt(), logCfg.value("format", "text").toString() == "binary");
     engine.rootContext()->setContextProperty("logger", &logger);
     Logger::getInstance()->write(QString("YIO App %1").arg(version));
 
@@ -259,5 +260,21 @@ int main(int argc, char* argv[]) {
     QObject* mainApplicationWindow = config->getQMLObject("applicationWindow");
     touchEventFilter->setSource(mainApplicationWindow);
 
+    // WAKE LATENCY
+    QQuickWindow* window = qobject_cast<QQuickWindow*>(mainApplicationWindow);
+    WakeLatency::getInstance()->setWindow(window);
+    if (cmdLineHandler.wakeBenchmark() > 0) {
+        InterruptHandlerMock* interruptHandler = qobject_cast<InterruptHandlerMock*>(hwFactory->getInterruptHandler());
+        ProximitySensorMock*  proximitySensor = qobject_cast<ProximitySensorMock*>(hwFactory->getProximitySensor());
+        if (interruptHandler == nullptr || proximitySensor == nullptr || window == nullptr) {
+            qCritical() << "The wake benchmark requires the mock hardware";
+            return 1;
+        }
+        WakeBenchmark* wakeBenchmark =
+            new WakeBenchmark(cmdLineHandler.wakeBenchmark(), cmdLineHandler.wakeLimit(), standbyControl,
+                              interruptHandler, proximitySensor, window, standbyControl);
+        wakeBenchmark->start();
+    }
+
     return app.exec();
 }
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#pragma once
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free ring buffer for multiple producers and a single consumer.
+ * Producers claim a slot with a compare-and-swap on the head position, the slot sequence number publishes the value to
+ * the consumer. Nothing is allocated after construction, push fails if the buffer is full.
+ */
+template <typename T>
+class MpscRingBuffer {
+ public:
+    // capacity is rounded up to a power of two
+    explicit MpscRingBuffer(quint32 capacity) : m_head(0), m_tail(0) {
+        quint32 size = 2;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_slots.reset(new Slot[size]);
+        for (quint32 i = 0; i < size; i++) {
+            m_slots[i].sequence.store(i);
+        }
+    }
+
+    // any thread, returns false if the buffer is full
+    bool push(T&& value) {
+        quint32 pos = m_head.load();
+        Slot*   slot;
+        for (;;) {
+            slot            = &m_slots[pos & m_mask];
+            qint32 distance = static_cast<qint32>(slot->sequence.loadAcquire() - pos);
+            if (distance == 0) {
+                if (m_head.testAndSetRelaxed(pos, pos + 1, pos)) {
+                    break;
+                }
+            } else if (distance < 0) {
+                return false;
+            } else {
+                pos = m_head.load();
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.storeRelease(pos + 1);
+        return true;
+    }
+
+    // consumer thread only, returns false if the buffer is empty
+    bool pop(T& value) {  // NOLINT we do not want a pointer for value
+        Slot*  slot     = &m_slots[m_tail & m_mask];
+        qint32 distance = static_cast<qint32>(slot->sequence.loadAcquire() - (m_tail + 1));
+        if (distance < 0) {
+            return false;
+        }
+        value = std::move(slot->value);
+        slot->sequence.storeRelease(m_tail + m_mask + 1);
+        m_tail++;
+        return true;
+    }
+
+ private:
+    struct Slot {
+        QAtomicInteger<quint32> sequence;
+        T                       value;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    quint32                 m_mask;
+    QAtomicInteger<quint32> m_head;  // next position to claim by producers
+    quint32                 m_tail;  // next position to read by the consumer
+};
@@ -23,6 +23,7 @@
 #include "standbycontrol.h"
 
 #include <QLoggingCategory>
+#include <QVector>
 #include <QtDebug>
 
 #include "yio-interface/integrationinterface.h"
@@ -33,22 +34,31 @@ StandbyControl *StandbyControl::s_instance = nullptr;
 
 void StandbyControl::setMode(int mode) {
     m_mode = mode;
+    updateScreenTime();
     if (m_mode == ON) {
         emit standByOff();
-        m_elapsedTime = 0;
+        m_idleTime.restart();
+        m_lastTransition = 0;
     }
     if (m_mode == STANDBY) {
         emit standByOn();
     }
     emit modeChanged();
+    scheduleTransition();
 }
 
 void StandbyControl::init() {
-    m_secondsTimer->start();
+    m_idleTime.start();
+    m_screenTime.start();
+    scheduleTransition();
+    m_batteryDataTimer->start();
     m_batteryFuelGauge->begin();
 }
 
-void StandbyControl::shutdown() { m_interruptHandler->shutdown(); }
+void StandbyControl::shutdown() {
+    m_config->flush();
+    m_interruptHandler->shutdown();
+}
 
 StandbyControl::StandbyControl(DisplayControl *displayControl, ProximitySensor *proximitySensor,
                                LightSensor *lightSensor, TouchEventFilter *touchEventFilter,
@@ -74,11 +84,13 @@ StandbyControl::StandbyControl(DisplayControl *displayControl, ProximitySensor *
     // connect to config change signals
     connect(m_config, &Config::settingsChanged, this, &StandbyControl::loadSettings);
 
-    // start timer that counts every seconds
-    m_secondsTimer->setInterval(1000);
-    // connect to timer signal
-    connect(m_secondsTimer, &QTimer::timeout, this, &StandbyControl::onSecondsTimerTimeout);
-    //    m_secondsTimer->start();
+    // the timer is armed for the next transition of the current mode
+    m_transitionTimer->setSingleShot(true);
+    connect(m_transitionTimer, &QTimer::timeout, this, &StandbyControl::onTransitionTimeout);
+
+    // battery data for the battery graph
+    m_batteryDataTimer->setInterval(m_batteryCheckTime * 1000);
+    connect(m_batteryDataTimer, &QTimer::timeout, this, &StandbyControl::getBatteryData);
 
     // connect to signals of hardware devices
     connect(m_touchEventFilter, &TouchEventFilter::detectedChanged, this, &StandbyControl::onTouchDetected);
@@ -114,6 +126,11 @@ QObject *StandbyControl::getQMLInstance(QQmlEngine *engine, QJSEngine *scriptEng
 }
 
 void StandbyControl::wakeup() {
+    if (mode() != ON) {
+        // measured from the wake event to the first frame, the display leaves standby in STANDBY and WIFI_OFF
+        m_wakeLatency->begin(mode() != DIM);
+    }
+
     switch (mode()) {
         case (DIM): {
             qCDebug(CLASS_LC) << "Wakeup from DIM";
@@ -144,11 +161,8 @@ void StandbyControl::wakeup() {
             timer->start(300);
 
             // integrations out of standby mode
-            for (int i = 0; i < m_integrations->list().length(); i++) {
-                IntegrationInterface *integrationObj =
-                    qobject_cast<IntegrationInterface *>(m_integrations->list().at(i));
-                integrationObj->leaveStandby();
-            }
+            m_integrations->scheduler()->invokeAll(&IntegrationInterface::leaveStandby,
+                                                   []() { WakeLatency::trace(WakeLatency::PHASE_INTEGRATIONS); });
 
             // start bluetooth scanning
 
@@ -178,11 +192,8 @@ void StandbyControl::wakeup() {
             readAmbientLight();
 
             // connect integrations
-            for (int i = 0; i < m_integrations->list().length(); i++) {
-                IntegrationInterface *integrationObj =
-                    qobject_cast<IntegrationInterface *>(m_integrations->list().at(i));
-                integrationObj->connect();
-            }
+            m_integrations->scheduler()->invokeAll(&IntegrationInterface::connect,
+                                                   []() { WakeLatency::trace(WakeLatency::PHASE_INTEGRATIONS); });
 
             m_api->start();
 
@@ -202,7 +213,77 @@ void StandbyControl::wakeup() {
         } break;
     }
 
-    m_elapsedTime = 0;
+    resetIdleTime();
+}
+
+void StandbyControl::resetIdleTime() {
+    m_idleTime.restart();
+    m_lastTransition = 0;
+    scheduleTransition();
+}
+
+void StandbyControl::scheduleTransition() {
+    if (!m_idleTime.isValid()) {
+        return;  // not initialized yet
+    }
+
+    // deadlines of the transitions out of the current mode, 0 means never
+    QVector<int> deadlines;
+    switch (m_mode) {
+        case ON:
+            deadlines = {m_displayDimTime};
+            break;
+        case DIM:
+            deadlines = {m_standByTime};
+            break;
+        case STANDBY:
+            deadlines = {m_wifiOffTime, m_shutDownTime};
+            break;
+        case WIFI_OFF:
+            deadlines = {m_shutDownTime};
+            break;
+    }
+
+    // a deadline which passed in another mode is not taken
+    m_nextTransition = 0;
+    for (int deadline : deadlines) {
+        if (deadline > m_lastTransition && (m_nextTransition == 0 || deadline < m_nextTransition)) {
+            m_nextTransition = deadline;
+        }
+    }
+
+    if (m_nextTransition == 0) {
+        // nothing to do until the next user activity
+        m_transitionTimer->stop();
+    } else {
+        m_transitionTimer->start(static_cast<int>(qMax<qint64>(0, m_nextTransition * 1000LL - m_idleTime.elapsed())));
+    }
+}
+
+void StandbyControl::updateScreenTime() {
+    bool screenOn = m_mode == ON || m_mode == DIM;
+    if (screenOn == m_screenOn) {
+        return;
+    }
+    if (m_screenTime.isValid()) {
+        (m_screenOn ? m_screenOnTime : m_screenOffTime) += m_screenTime.restart();
+    }
+    m_screenOn = screenOn;
+    emit screenOnTimeChanged();
+    emit screenOffTimeChanged();
+}
+
+int StandbyControl::screenTime(bool on) {
+    qint64 time = on ? m_screenOnTime : m_screenOffTime;
+    if (on == m_screenOn && m_screenTime.isValid()) {
+        time += m_screenTime.elapsed();
+    }
+    return static_cast<int>(time / 1000);
+}
+
+void StandbyControl::refreshScreenTime() {
+    emit screenOnTimeChanged();
+    emit screenOffTimeChanged();
 }
 
 void StandbyControl::readAmbientLight() {
@@ -214,6 +295,7 @@ void StandbyControl::readAmbientLight() {
     } else {
         m_displayControl->setBrightness(m_displayControl->userBrightness());
     }
+    WakeLatency::trace(WakeLatency::PHASE_AMBIENT_LIGHT);
 }
 
 int StandbyControl::mapValues(int inValue, int minInRange, int maxInRange, int minOutRange, int maxOutRange) {
@@ -256,33 +338,50 @@ void StandbyControl::getBatteryData() {
     emit batteryDataChanged();
 }
 
-void StandbyControl::onSecondsTimerTimeout() {
-    // increase the elapsed time
-    m_elapsedTime++;
+void StandbyControl::enterStandby() {
+    // turn on proximity detection
+    m_proximitySensor->proximityDetection(true);
 
-    // increase battery data logger time
-    m_batteryCheckElapsedTime++;
+    // turn off backlight
+    m_displayControl->setBrightness(0);
 
-    if (m_batteryCheckElapsedTime == m_batteryCheckTime) {
-        m_batteryCheckElapsedTime = 0;
-        getBatteryData();
-    }
+    // put the display to standby mode
+    m_displayControl->setMode(DisplayControl::StandbyOn);
 
-    // if it's on, then inscrease screen on time
-    if (m_mode == ON || m_mode == DIM) {
-        m_screenOnTime++;
-        emit screenOnTimeChanged();
-    }
+    // TODO(martonborzak):
+    // stop bluetooth scanning
 
-    // if it's standby, then inscrease screen off time
-    if (m_mode == STANDBY || m_mode == WIFI_OFF) {
-        m_screenOffTime++;
-        emit screenOffTimeChanged();
-    }
+    // reset battery charging screen
+    QObject *resetClock = m_config->getQMLObject("resetClock");
+    QMetaObject::invokeMethod(resetClock, "start", Qt::AutoConnection);
+
+    // enable touch event catcher
+    QObject *touchEventCatcher = m_config->getQMLObject("touchEventCatcher");
+    touchEventCatcher->setProperty("enabled", true);
+
+    setMode(STANDBY);
+
+    // integrations set standby mode
+    m_integrations->scheduler()->invokeAll(&IntegrationInterface::enterStandby);
+
+    m_format.setSwapInterval(60);
+    QSurfaceFormat::setDefaultFormat(m_format);
+    qCDebug(CLASS_LC) << "Changing swap interval to " << m_format.swapInterval();
+
+    qCDebug(CLASS_LC) << "State set to STANDBY";
+
+    // TODO(martonborzak):
+    // turn off bluetooth 20 seconds after standby if bluetootharea is enabled, with its own deadline
+}
+
+void StandbyControl::onTransitionTimeout() {
+    // all transitions of this deadline are done, in the order of the modes
+    int elapsedTime  = m_nextTransition;
+    m_lastTransition = elapsedTime;
 
     // STATE CONTROL
     // DIM
-    if (m_elapsedTime == m_displayDimTime && m_mode == ON) {
+    if (elapsedTime == m_displayDimTime && m_mode == ON) {
         // dim the display
         m_displayControl->setBrightness(10);
 
@@ -292,57 +391,15 @@ void StandbyControl::onSecondsTimerTimeout() {
     }
 
     // STANDBY
-    if (m_elapsedTime == m_standByTime && m_mode == DIM) {
-        // turn on proximity detection
-        m_proximitySensor->proximityDetection(true);
-
-        // turn off backlight
-        m_displayControl->setBrightness(0);
-
-        // put the display to standby mode
-        m_displayControl->setMode(DisplayControl::StandbyOn);
-
-        // TODO(martonborzak):
-        // stop bluetooth scanning
-
-        // reset battery charging screen
-        QObject *resetClock = m_config->getQMLObject("resetClock");
-        QMetaObject::invokeMethod(resetClock, "start", Qt::AutoConnection);
-
-        // enable touch event catcher
-        QObject *touchEventCatcher = m_config->getQMLObject("touchEventCatcher");
-        touchEventCatcher->setProperty("enabled", true);
-
-        setMode(STANDBY);
-
-        // integrations set standby mode
-        for (int i = 0; i < m_integrations->list().length(); i++) {
-            IntegrationInterface *integrationObj = qobject_cast<IntegrationInterface *>(m_integrations->list().at(i));
-            integrationObj->enterStandby();
-        }
-
-        m_format.setSwapInterval(60);
-        QSurfaceFormat::setDefaultFormat(m_format);
-        qCDebug(CLASS_LC) << "Changing swap interval to " << m_format.swapInterval();
-
-        qCDebug(CLASS_LC) << "State set to STANDBY";
-    }
-
-    // TURN OFF BLUETOOTH
-    if (m_elapsedTime == m_standByTime + 20 && m_mode == STANDBY &&
-        m_config->getSettings().value("bluetootharea").toBool()) {
-        // TODO(martonborzak):
-        // turn off bluetooth
+    if (elapsedTime == m_standByTime && m_mode == DIM) {
+        enterStandby();
     }
 
     // TURN OFF WIFI
-    if (m_elapsedTime == m_wifiOffTime && m_wifiOffTime != 0 && m_mode == STANDBY &&
+    if (elapsedTime == m_wifiOffTime && m_wifiOffTime != 0 && m_mode == STANDBY &&
         m_batteryFuelGauge->getAveragePower() <= 0) {
         // disconnect integrations
-        for (int i = 0; i < m_integrations->list().length(); i++) {
-            IntegrationInterface *integrationObj = qobject_cast<IntegrationInterface *>(m_integrations->list().at(i));
-            integrationObj->disconnect();
-        }
+        m_integrations->scheduler()->invokeAll(&IntegrationInterface::disconnect);
 
         // turn off API
         m_api->stop();
@@ -355,7 +412,7 @@ void StandbyControl::onSecondsTimerTimeout() {
     }
 
     // SHUTDOWN
-    if (m_elapsedTime == m_shutDownTime && m_shutDownTime != 0 && (m_mode == STANDBY || m_mode == WIFI_OFF) &&
+    if (elapsedTime == m_shutDownTime && m_shutDownTime != 0 && (m_mode == STANDBY || m_mode == WIFI_OFF) &&
         m_batteryFuelGauge->getAveragePower() < 0 && !m_batteryFuelGauge->getIsCharging()) {
         qCInfo(CLASS_LC) << "TIMER SHUTDOWN"
                          << "Average power:" << m_batteryFuelGauge->getAveragePower()
@@ -366,12 +423,15 @@ void StandbyControl::onSecondsTimerTimeout() {
         loadingScreen->setProperty("source", "qrc:/basic_ui/ClosingScreen.qml");
         loadingScreen->setProperty("active", true);
     }
+
+    scheduleTransition();
 }
 
 void StandbyControl::loadSettings() {
     QVariantMap settings = m_config->getSettings();
     m_wifiOffTime        = settings.value("wifitime").toInt();
     m_shutDownTime       = settings.value("shutdowntime").toInt();
+    scheduleTransition();
 }
 
 void StandbyControl::onTouchDetected() {
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSurfaceFormat>
 #include <QTimer>
@@ -32,6 +33,7 @@
 #include "hardware/hardwarefactory.h"
 #include "hardware/touchdetect.h"
 #include "integrations/integrations.h"
+#include "wakelatency.h"
 #include "yioapi.h"
 
 class StandbyControl : public QObject {
@@ -53,9 +55,14 @@ class StandbyControl : public QObject {
     Q_INVOKABLE void shutdown();
 
     Q_INVOKABLE void wakeup();
+    // turns the display off and puts the integrations to standby, done after the standby time or by the wake benchmark
+    Q_INVOKABLE void enterStandby();
 
-    QString screenOnTime() { return secondsToHours(m_screenOnTime); }
-    QString screenOffTime() { return secondsToHours(m_screenOffTime); }
+    QString screenOnTime() { return secondsToHours(screenTime(true)); }
+    QString screenOffTime() { return secondsToHours(screenTime(false)); }
+
+    // the screen times are only notified when the screen is turned on or off, displays of the running time refresh them
+    Q_INVOKABLE void refreshScreenTime();
 
     QVariant batteryData() { return m_batteryData; }
 
@@ -90,6 +97,7 @@ class StandbyControl : public QObject {
     ButtonHandler*    m_buttonHandler;
     WifiControl*      m_wifiControl;
     BatteryFuelGauge* m_batteryFuelGauge;
+    WakeLatency*      m_wakeLatency = new WakeLatency(this);
 
     int m_mode = ON;
 
@@ -98,20 +106,32 @@ class StandbyControl : public QObject {
     int m_wifiOffTime    = 0;   // seconds, 0 means never, loaded from config.settings
     int m_shutDownTime   = 0;   // seconds, 0 means never, loaded from config.settings
 
-    int m_screenOnTime  = 0;  // seconds
-    int m_screenOffTime = 0;  // seconds
+    // The transitions are deadlines in seconds since the last user activity. Only the timer of the next transition of
+    // the current mode is armed, nothing runs in between.
+    QElapsedTimer m_idleTime;                            // since the last user activity
+    QTimer*       m_transitionTimer = new QTimer(this);  // single shot, armed for m_nextTransition
+    int           m_nextTransition  = 0;                 // seconds, deadline the timer is armed for
+    int           m_lastTransition  = 0;                 // seconds, deadlines up to this one are handled
+
+    // screen times are accumulated when the screen is turned on or off
+    qint64        m_screenOnTime  = 0;  // ms
+    qint64        m_screenOffTime = 0;  // ms
+    bool          m_screenOn      = true;
+    QElapsedTimer m_screenTime;  // since the screen was turned on or off
 
-    QTimer* m_secondsTimer = new QTimer(this);
-    int     m_elapsedTime  = 0;  // seconds
+    void   resetIdleTime();
+    void   scheduleTransition();
+    void   updateScreenTime();
+    int    screenTime(bool on);  // seconds
 
     void    readAmbientLight();
     int     mapValues(int inValue, int minInRange, int maxInRange, int minOutRange, int maxOutRange);
     QString secondsToHours(int value);
 
-    int     m_batteryCheckElapsedTime = 0;    // seconds
-    int     m_batteryCheckTime        = 600;  // seconds
-    QTimer* m_shutdownTimer           = new QTimer(this);
-    int     m_shutDownDelay           = 20000;  // miliseconds
+    QTimer* m_batteryDataTimer = new QTimer(this);
+    int     m_batteryCheckTime = 600;  // seconds
+    QTimer* m_shutdownTimer    = new QTimer(this);
+    int     m_shutDownDelay    = 20000;  // miliseconds
 
     void         getBatteryData();
     QVariantList m_batteryData;
@@ -122,7 +142,7 @@ class StandbyControl : public QObject {
     QSurfaceFormat m_format = QSurfaceFormat::defaultFormat();
 
  private slots:  // NOLINT open issue: https://github.com/cpplint/cpplint/pull/99
-    void onSecondsTimerTimeout();
+    void onTransitionTimeout();
     void loadSettings();
     void onTouchDetected();
     void onProximityDetected();
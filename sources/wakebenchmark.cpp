@@ -0,0 +1,117 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include "wakebenchmark.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QMouseEvent>
+
+static Q_LOGGING_CATEGORY(CLASS_LC, "wakebenchmark");
+
+WakeBenchmark::WakeBenchmark(int iterations, int limit, StandbyControl* standbyControl,
+                             InterruptHandlerMock* interruptHandler, ProximitySensorMock* proximitySensor,
+                             QQuickWindow* window, QObject* parent)
+    : QObject(parent),
+      m_iterations(iterations),
+      m_limit(limit),
+      m_standbyControl(standbyControl),
+      m_interruptHandler(interruptHandler),
+      m_proximitySensor(proximitySensor),
+      m_window(window),
+      m_timeout(new QTimer(this)) {
+    m_timeout->setSingleShot(true);
+    m_timeout->setInterval(WAKE_TIMEOUT);
+    connect(m_timeout, &QTimer::timeout, this, &WakeBenchmark::onTimeout);
+    // emitted by the render thread
+    connect(WakeLatency::getInstance(), &WakeLatency::measured, this, &WakeBenchmark::onMeasured,
+            Qt::QueuedConnection);
+}
+
+void WakeBenchmark::start() {
+    qCInfo(CLASS_LC) << "Wake benchmark with" << m_iterations << "iterations";
+    WakeLatency::getInstance()->reset();
+    QTimer::singleShot(STARTUP_DELAY, this, &WakeBenchmark::next);
+}
+
+void WakeBenchmark::next() {
+    if (m_iteration >= m_iterations) {
+        finish();
+        return;
+    }
+    m_standbyControl->enterStandby();
+    QTimer::singleShot(SETTLE_TIME, this, &WakeBenchmark::replayWakeEvent);
+}
+
+void WakeBenchmark::replayWakeEvent() {
+    m_waiting = true;
+    m_timeout->start();
+
+    // touch, proximity and button in turn
+    switch (m_iteration % WakeLatency::SOURCE_OTHER) {
+        case WakeLatency::SOURCE_TOUCH: {
+            QPointF      pos(m_window->width() / 2, m_window->height() / 2);
+            QMouseEvent press(QEvent::MouseButtonPress, pos, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+            QMouseEvent release(QEvent::MouseButtonRelease, pos, Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+            QCoreApplication::sendEvent(m_window, &press);
+            QCoreApplication::sendEvent(m_window, &release);
+        } break;
+        case WakeLatency::SOURCE_PROXIMITY:
+            m_proximitySensor->simulateProximity();
+            break;
+        case WakeLatency::SOURCE_BUTTON:
+            // press and release
+            m_interruptHandler->simulateInterrupt(InterruptHandler::DPAD_MIDDLE);
+            m_interruptHandler->simulateInterrupt(InterruptHandler::DPAD_MIDDLE);
+            break;
+    }
+}
+
+void WakeBenchmark::onMeasured() {
+    if (!m_waiting) {
+        return;
+    }
+    m_waiting = false;
+    m_timeout->stop();
+    m_iteration++;
+    QTimer::singleShot(SETTLE_TIME, this, &WakeBenchmark::next);
+}
+
+void WakeBenchmark::onTimeout() {
+    qCWarning(CLASS_LC) << "Wakeup" << m_iteration << "did not reach the first frame";
+    m_waiting = false;
+    m_failures++;
+    m_iteration++;
+    QTimer::singleShot(SETTLE_TIME, this, &WakeBenchmark::next);
+}
+
+void WakeBenchmark::finish() {
+    QVariantMap statistics = WakeLatency::getInstance()->statistics();
+    qCInfo(CLASS_LC).noquote() << QJsonDocument::fromVariant(statistics).toJson(QJsonDocument::Indented);
+
+    double slowest = statistics.value("phases").toMap().value("first_frame").toMap().value("max").toDouble();
+    bool   passed = m_failures == 0 && (m_limit == 0 || slowest <= m_limit);
+    qCInfo(CLASS_LC) << "Wake benchmark" << (passed ? "passed" : "failed") << "failures:" << m_failures
+                     << "slowest first frame:" << slowest << "ms limit:" << m_limit << "ms";
+    QCoreApplication::exit(passed ? 0 : 1);
+}
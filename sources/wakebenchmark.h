@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QQuickWindow>
+#include <QTimer>
+
+#include "hardware/mock/interrupthandler_mock.h"
+#include "hardware/mock/proximitysensor_mock.h"
+#include "standbycontrol.h"
+
+/**
+ * @brief Wake latency benchmark with the mock hardware.
+ * Puts the remote into standby and replays a wake event, alternating touch, proximity and button, for the given number
+ * of iterations. Afterwards the wake latency statistics are written to the log and the application exits with 1 if a
+ * wakeup did not reach its first frame or the slowest first frame exceeded the limit, so it can run in CI.
+ */
+class WakeBenchmark : public QObject {
+    Q_OBJECT
+
+ public:
+    explicit WakeBenchmark(int iterations, int limit, StandbyControl* standbyControl,
+                           InterruptHandlerMock* interruptHandler, ProximitySensorMock* proximitySensor,
+                           QQuickWindow* window, QObject* parent = nullptr);
+
+    void start();
+
+ private:
+    static const int STARTUP_DELAY = 5000;  // ms for loading the UI before the first iteration
+    static const int SETTLE_TIME = 1000;    // ms in standby before the wake event, and after the wakeup
+    static const int WAKE_TIMEOUT = 5000;   // ms for a wakeup to reach the first frame
+
+    void next();
+    void replayWakeEvent();
+    void onMeasured();
+    void onTimeout();
+    void finish();
+
+    int                   m_iterations;
+    int                   m_limit;  // ms, 0 means no limit
+    int                   m_iteration = 0;
+    int                   m_failures = 0;
+    bool                  m_waiting = false;
+    StandbyControl*       m_standbyControl;
+    InterruptHandlerMock* m_interruptHandler;
+    ProximitySensorMock*  m_proximitySensor;
+    QQuickWindow*         m_window;
+    QTimer*               m_timeout;
+};
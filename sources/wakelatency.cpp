@@ -0,0 +1,192 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include "wakelatency.h"
+
+#include <QLoggingCategory>
+#include <QMetaEnum>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+static Q_LOGGING_CATEGORY(CLASS_LC, "wakelatency");
+
+WakeLatency*  WakeLatency::s_instance = nullptr;
+QElapsedTimer WakeLatency::s_clock;
+const int     WakeLatency::BUCKET_LIMITS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+WakeLatency::WakeLatency(QObject* parent) : QObject(parent), m_measuring(0) {
+    s_instance = this;
+    s_clock.start();
+    std::fill(m_phases, m_phases + PHASE_COUNT, -1);
+}
+
+WakeLatency::~WakeLatency() { s_instance = nullptr; }
+
+qint64 WakeLatency::now() { return s_clock.isValid() ? s_clock.nsecsElapsed() : 0; }
+
+void WakeLatency::interrupt(Source source, qint64 timestamp) {
+    WakeLatency* instance = s_instance;
+    if (instance == nullptr) {
+        return;
+    }
+    QMutexLocker lock(&instance->m_mutex);
+    instance->m_interruptTime = timestamp < 0 ? now() : timestamp;
+    instance->m_interruptSource = source;
+}
+
+void WakeLatency::trace(Phase phase) {
+    WakeLatency* instance = s_instance;
+    if (instance == nullptr || !instance->m_measuring.load()) {
+        return;
+    }
+    qint64 time = now();
+    {
+        QMutexLocker lock(&instance->m_mutex);
+        if (!instance->m_measuring.load() || instance->m_phases[phase] >= 0) {
+            return;
+        }
+        instance->m_phases[phase] = time - instance->m_start;
+    }
+    if (phase == PHASE_DISPLAY) {
+        // the display may show an unchanged scene, the first frame after it is on is requested
+        QMetaObject::invokeMethod(instance,
+                                  [instance]() {
+                                      if (instance->m_window) {
+                                          instance->m_window->update();
+                                      }
+                                  },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void WakeLatency::begin(bool displayStandby) {
+    qint64       time = now();
+    QMutexLocker lock(&m_mutex);
+    if (m_measuring.load()) {
+        qCDebug(CLASS_LC) << "Measurement without a first frame dropped";
+    }
+
+    // every wake event starts one measurement, wakeups without a recent wake event are measured from now
+    bool recent = m_interruptTime >= 0 && time - m_interruptTime <= INTERRUPT_AGE * 1000000;
+    m_start = recent ? m_interruptTime : time;
+    m_source = recent ? m_interruptSource : SOURCE_OTHER;
+    m_interruptTime = -1;
+    m_displayStandby = displayStandby;
+    std::fill(m_phases, m_phases + PHASE_COUNT, -1);
+    m_phases[PHASE_WAKEUP] = time - m_start;
+    m_measuring.store(1);
+}
+
+void WakeLatency::setWindow(QQuickWindow* window) {
+    if (m_window) {
+        disconnect(m_window, &QQuickWindow::frameSwapped, this, &WakeLatency::onFrameSwapped);
+    }
+    m_window = window;
+    if (m_window) {
+        connect(m_window, &QQuickWindow::frameSwapped, this, &WakeLatency::onFrameSwapped, Qt::DirectConnection);
+    }
+}
+
+void WakeLatency::onFrameSwapped() {
+    if (!m_measuring.load()) {
+        return;
+    }
+    qint64 time = now();
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_measuring.load() || (m_displayStandby && m_phases[PHASE_DISPLAY] < 0)) {
+            return;
+        }
+        m_phases[PHASE_FIRST_FRAME] = time - m_start;
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            if (m_phases[i] >= 0) {
+                m_histograms[i].add(m_phases[i] / 1000);
+            }
+        }
+        m_sources[m_source]++;
+        m_measuring.store(0);
+    }
+    emit measured();
+}
+
+QVariantMap WakeLatency::statistics() {
+    QMetaEnum phaseEnum = QMetaEnum::fromType<Phase>();
+    QMetaEnum sourceEnum = QMetaEnum::fromType<Source>();
+
+    QMutexLocker lock(&m_mutex);
+    QVariantMap  phases;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        phases.insert(QString(phaseEnum.valueToKey(i)).mid(6).toLower(), m_histograms[i].toMap());  // without PHASE_
+    }
+    QVariantMap sources;
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        sources.insert(QString(sourceEnum.valueToKey(i)).mid(7).toLower(), m_sources[i]);  // without SOURCE_
+    }
+
+    QVariantMap statistics;
+    statistics.insert("phases", phases);
+    statistics.insert("sources", sources);
+    return statistics;
+}
+
+void WakeLatency::reset() {
+    QMutexLocker lock(&m_mutex);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        m_histograms[i] = Histogram();
+    }
+    std::fill(m_sources, m_sources + SOURCE_COUNT, 0);
+}
+
+void WakeLatency::Histogram::add(qint64 value) {
+    min = count == 0 ? value : qMin(min, value);
+    max = qMax(max, value);
+    last = value;
+    sum += value;
+    count++;
+
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && value > BUCKET_LIMITS[bucket] * 1000LL) {
+        bucket++;
+    }
+    buckets[bucket]++;
+}
+
+QVariantMap WakeLatency::Histogram::toMap() const {
+    // times in ms
+    QVariantMap map;
+    map.insert("count", count);
+    map.insert("min", min / 1000.0);
+    map.insert("max", max / 1000.0);
+    map.insert("avg", count > 0 ? sum / 1000.0 / count : 0.0);
+    map.insert("last", last / 1000.0);
+
+    QVariantList histogram;
+    for (int i = 0; i < BUCKETS; i++) {
+        QVariantMap bucket;
+        bucket.insert("le", i < BUCKETS - 1 ? QVariant(BUCKET_LIMITS[i]) : QVariant("inf"));
+        bucket.insert("count", buckets[i]);
+        histogram.append(bucket);
+    }
+    map.insert("histogram", histogram);
+    return map;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of the YIO-Remote software project.
+ *
+ * YIO-Remote software is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * YIO-Remote software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with YIO-Remote software. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QQuickWindow>
+#include <QVariantMap>
+
+/**
+ * @brief Tracepoints and latency histograms of the wakeup path, from the wake event to the first rendered frame.
+ * The hardware drivers mark the time of every wake event with interrupt(). StandbyControl::wakeup starts a measurement
+ * when the remote is not ON, the phases of the wakeup are timestamped with trace() relative to the wake event and the
+ * measurement ends with the first frame swapped after the display left standby. Tracepoints are cheap no-ops while no
+ * measurement is running and may be called from any thread.
+ */
+class WakeLatency : public QObject {
+    Q_OBJECT
+
+ public:
+    enum Source { SOURCE_TOUCH, SOURCE_PROXIMITY, SOURCE_BUTTON, SOURCE_OTHER, SOURCE_COUNT };
+    Q_ENUM(Source)
+
+    enum Phase {
+        PHASE_WAKEUP,         // StandbyControl::wakeup entered
+        PHASE_INTEGRATIONS,   // all integrations returned from leaveStandby or connect, on their threads
+        PHASE_DISPLAY,        // display out of standby
+        PHASE_AMBIENT_LIGHT,  // brightness set from the ambient light
+        PHASE_FIRST_FRAME,    // first frame swapped after the display is on
+        PHASE_COUNT
+    };
+    Q_ENUM(Phase)
+
+    // TRACEPOINTS
+    static qint64 now();  // ns, monotonic
+    // wake event of the hardware, timestamp from now() if the event was read later than it arrived
+    static void interrupt(Source source, qint64 timestamp = -1);
+    // phase of the running measurement reached, only the first time counts
+    static void trace(Phase phase);
+
+    /**
+     * @brief begin Starts a measurement from the last wake event, called by StandbyControl::wakeup
+     * @param displayStandby true if the display has to leave standby, the first frame is taken after it did
+     */
+    void begin(bool displayStandby);
+
+    // the first frame is measured with the frameSwapped signal of the window
+    void setWindow(QQuickWindow* window);
+
+    // histograms by phase, in ms since the wake event
+    Q_INVOKABLE QVariantMap statistics();
+    Q_INVOKABLE void        reset();
+
+    explicit WakeLatency(QObject* parent = nullptr);
+    ~WakeLatency() override;
+
+    static WakeLatency* getInstance() { return s_instance; }
+
+ signals:
+    // a measurement is complete, emitted by the render thread
+    void measured();
+
+ private:
+    static const int    BUCKETS = 13;
+    static const int    BUCKET_LIMITS[BUCKETS - 1];  // ms, upper limits, the last bucket has none
+    static const qint64 INTERRUPT_AGE = 1000;        // ms, older wake events do not start a measurement
+
+    struct Histogram {
+        int    count = 0;
+        qint64 sum = 0;   // us
+        qint64 min = 0;   // us
+        qint64 max = 0;   // us
+        qint64 last = 0;  // us
+        int    buckets[BUCKETS] = {};
+
+        void        add(qint64 value);
+        QVariantMap toMap() const;
+    };
+
+    // render thread
+    void onFrameSwapped();
+
+    static WakeLatency*  s_instance;
+    static QElapsedTimer s_clock;
+
+    QMutex                 m_mutex;
+    QAtomicInt             m_measuring;             // checked without the mutex by the tracepoints
+    qint64                 m_interruptTime = -1;    // ns, last wake event
+    Source                 m_interruptSource = SOURCE_OTHER;
+    qint64                 m_start = 0;             // ns, wake event of the measurement
+    Source                 m_source = SOURCE_OTHER;
+    bool                   m_displayStandby = false;
+    qint64                 m_phases[PHASE_COUNT];   // ns since m_start, -1 not reached
+    Histogram              m_histograms[PHASE_COUNT];
+    int                    m_sources[SOURCE_COUNT] = {};
+    QPointer<QQuickWindow> m_window;
+};
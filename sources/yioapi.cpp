@@ -22,17 +22,31 @@
 
 #include "yioapi.h"
 
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLoggingCategory>
+#include <QMetaEnum>
 #include <QNetworkInterface>
+#include <QPointer>
+#include <QSharedPointer>
 #include <QTimer>
+#include <QVector>
 #include <QtDebug>
 
+#include <functional>
+
+#include "hardware/buttonhandler.h"
+#include "hardware/hardwarefactory.h"
 #include "launcher.h"
+#include "logger.h"
 #include "standbycontrol.h"
 #include "translation.h"
+#include "wakelatency.h"
 
 static Q_LOGGING_CATEGORY(CLASS_LC, "api");
 
@@ -43,6 +57,23 @@ YioAPI::YioAPI(QQmlApplicationEngine *engine) : m_engine(engine) {
     m_entities     = Entities::getInstance();
     m_integrations = Integrations::getInstance();
     m_config       = Config::getInstance();
+
+    m_eventTimer = new QTimer(this);
+    m_eventTimer->setSingleShot(true);
+    m_eventTimer->setInterval(EVENT_BATCH_DELAY);
+    connect(m_eventTimer, &QTimer::timeout, this, &YioAPI::onEventTimeout);
+
+    m_entityFrameTimer = new QTimer(this);
+    m_entityFrameTimer->setSingleShot(true);
+    m_entityFrameTimer->setInterval(ENTITY_FRAME_INTERVAL);
+    connect(m_entityFrameTimer, &QTimer::timeout, this, &YioAPI::onEntityFrameTimeout);
+
+    m_logFrameTimer = new QTimer(this);
+    m_logFrameTimer->setSingleShot(true);
+    m_logFrameTimer->setInterval(LOG_FRAME_INTERVAL);
+    connect(m_logFrameTimer, &QTimer::timeout, this, &YioAPI::onLogFrameTimeout);
+
+    registerApiHandlers();
 }
 
 YioAPI::~YioAPI() { s_instance = nullptr; }
@@ -81,6 +112,15 @@ void YioAPI::start() {
 void YioAPI::stop() {
     m_server->close();
     m_clients.clear();
+    m_binaryClients.clear();
+    m_eventSubscribers.clear();
+    m_pendingEvents.clear();
+    m_entitySubscribers.clear();
+    m_changedEntities.clear();
+    m_logSubscribers.clear();
+    if (Logger::getInstance() != nullptr) {
+        Logger::getInstance()->setStreamEnabled(false);
+    }
     m_running = false;
     m_zeroConf.stopServicePublish();
     emit runningChanged();
@@ -99,87 +139,92 @@ void YioAPI::sendMessage(QString message) {
 QVariantMap YioAPI::getConfig() { return m_config->getConfig(); }
 
 bool YioAPI::setConfig(QVariantMap config) {
+    // the validated config is persisted by the delayed config writer
     m_config->setConfig(config);
-    if (!m_config->isValid()) {
-        return false;
-    }
-
-    return m_config->writeConfig();
+    return m_config->isValid();
 }
 
 bool YioAPI::addEntity(QVariantMap entity) {
-    // get the type of the new entity
-    QString entityType = entity.value("type").toString();
-    qCDebug(CLASS_LC) << "Adding entity type:" << entityType;
+    QStringList errors;
+    return addEntities({entity}, errors);
+}
 
-    // remove the key that is not needed
-    entity.remove("type");
+bool YioAPI::addEntities(const QVariantList &entities, QStringList &errors) {
+    QVariantMap   configEntities = getConfig().value("entities").toMap();
+    QVariantList  newEntities;
+    QSet<QString> newEntityIds;
+
+    // check all entities before changing anything: either all or none are added
+    for (const QVariant &item : entities) {
+        QVariantMap entity     = item.toMap();
+        QString     entityType = entity.value("type").toString();
+        QString     entityId   = entity.value(Config::KEY_ENTITY_ID).toString();
+        qCDebug(CLASS_LC) << "Adding entity" << entityId << "type:" << entityType;
+
+        // remove the key that is not needed
+        entity.remove("type");
+
+        // check if the type is supported
+        if (!m_entities->supportedEntities().contains(entityType)) {
+            errors.append(entityId + ": unsupported entity type " + entityType);
+            continue;
+        }
 
-    // check if the type is supported
-    if (!m_entities->supportedEntities().contains(entityType)) {
-        return false;
-    }
+        // check the input if it's OK
+        if (!entity.contains(Config::KEY_AREA) && !entity.contains(Config::KEY_ENTITY_ID) &&
+            !entity.contains(Config::KEY_FRIENDLYNAME) && !entity.contains(Config::KEY_INTEGRATION) &&
+            !entity.contains(Config::KEY_SUPPORTED_FEATURES) && !entity.contains(Config::KEY_TYPE)) {
+            errors.append(entityId + ": invalid entity data");
+            continue;
+        }
 
-    qCDebug(CLASS_LC) << "Entity type is supported";
+        // check if entity alread loaded. If so, it exist in config.json and the database
+        if (m_entities->get(entityId) || newEntityIds.contains(entityId)) {
+            errors.append(entityId + ": entity already exists");
+            continue;
+        }
 
-    // check the input if it's OK
-    if (!entity.contains(Config::KEY_AREA) && !entity.contains(Config::KEY_ENTITY_ID) &&
-        !entity.contains(Config::KEY_FRIENDLYNAME) && !entity.contains(Config::KEY_INTEGRATION) &&
-        !entity.contains(Config::KEY_SUPPORTED_FEATURES) && !entity.contains(Config::KEY_TYPE)) {
-        return false;
-    }
+        if (!m_integrations->get(entity.value(Config::KEY_INTEGRATION).toString())) {
+            errors.append(entityId + ": integration not loaded");
+            continue;
+        }
 
-    qCDebug(CLASS_LC) << "Input data is OK.";
+        // add the entity to the list
+        QVariantList entitiesType = configEntities.value(entityType).toList();
+        entitiesType.append(entity);
+        configEntities.insert(entityType, entitiesType);
 
-    // check if entity alread loaded. If so, it exist in config.json and the database
-    QObject *eObj = m_entities->get(entity.value("entity_id").toString());
+        newEntityIds.insert(entityId);
+        entity.insert("type", entityType);
+        newEntities.append(entity);
+    }
 
-    qCDebug(CLASS_LC) << "Entity object:" << eObj;
-    if (eObj) {
-        qCDebug(CLASS_LC) << "Entity is loaded.";
+    if (!errors.isEmpty() || newEntities.isEmpty()) {
+        qCDebug(CLASS_LC) << "Add entities success: false" << errors;
         return false;
     }
 
-    qCDebug(CLASS_LC) << "Entity is not loaded.";
-
-    // get the config
-    QVariantMap  c            = getConfig();
-    QVariantMap  entities     = c.value("entities").toMap();
-    QVariantList entitiesType = entities.value(entityType).toList();
-
-    // add the entity to the lsit
-    entitiesType.append(entity);
-
-    // put entities back to config
-    entities.insert(entityType, entitiesType);
-    c.insert("entities", entities);
-
-    // write the config back
-    bool success = setConfig(c);
-
-    delete eObj;
-
-    // if the config write is successful, load the entity to the database
-    if (success) {
-        // get the integration object
-        QObject *obj = m_integrations->get(entity.value("integration").toString());
-        if (obj) {
-            IntegrationInterface *integration = qobject_cast<IntegrationInterface *>(obj);
+    // write the config back with one change: only the entities section is validated
+    if (!m_config->patchConfig({{"entities", configEntities}})) {
+        errors.append(m_config->getError());
+        qCDebug(CLASS_LC) << "Add entities success: false" << errors;
+        return false;
+    }
 
-            // add it to the entity registry
-            m_entities->add(entityType, entity, integration);
+    // load the entities to the database
+    for (const QVariant &item : newEntities) {
+        QVariantMap entity     = item.toMap();
+        QString     entityType = entity.take("type").toString();
 
-            qCDebug(CLASS_LC) << "Add entity success: true";
+        QObject *             obj         = m_integrations->get(entity.value(Config::KEY_INTEGRATION).toString());
+        IntegrationInterface *integration = qobject_cast<IntegrationInterface *>(obj);
 
-            return true;
-        } else {
-            qCDebug(CLASS_LC) << "Add entity success: false";
-            return false;
-        }
-    } else {
-        qCDebug(CLASS_LC) << "Add entity success: false";
-        return false;
+        // add it to the entity registry
+        m_entities->add(entityType, entity, integration);
     }
+
+    qCDebug(CLASS_LC) << "Add entities success: true" << newEntities.size();
+    return true;
 }
 
 bool YioAPI::updatEntity(QVariantMap entity) {
@@ -195,80 +240,100 @@ bool YioAPI::updatEntity(QVariantMap entity) {
 }
 
 bool YioAPI::removeEntity(QString entityId) {
-    qCDebug(CLASS_LC) << "Removing entity:" << entityId;
+    QStringList errors;
+    return removeEntities({entityId}, errors);
+}
 
-    QObject *        o = m_entities->get(entityId);
-    EntityInterface *eIface;
-    if (o) {
-        eIface = qobject_cast<EntityInterface *>(o);
-    } else {
+bool YioAPI::removeEntities(const QStringList &entityIds, QStringList &errors) {
+    qCDebug(CLASS_LC) << "Removing entities:" << entityIds;
+
+    // check all entities before changing anything: either all or none are removed
+    QSet<QString> removeIds;
+    QSet<QString> removeTypes;
+    for (const QString &entityId : entityIds) {
+        Entity *entity = qobject_cast<Entity *>(m_entities->get(entityId));
+        if (entity) {
+            removeIds.insert(entityId);
+            removeTypes.insert(entity->type());
+        } else {
+            errors.append(entityId + ": entity not loaded");
+        }
+    }
+
+    if (!errors.isEmpty() || removeIds.isEmpty()) {
         return false;
     }
 
-    // remove entity from groups
+    // remove entities from groups
     QVariantMap groups = m_config->getGroups();
-    for (QVariantMap::const_iterator iter = groups.begin(); iter != groups.end(); ++iter) {
+    for (QVariantMap::iterator iter = groups.begin(); iter != groups.end(); ++iter) {
         QVariantMap  item          = iter.value().toMap();
         QVariantList groupEntities = item.value("entities").toList();
-        for (int i = 0; i < groupEntities.length(); i++) {
-            if (groupEntities[i].toString() == entityId) {
+        int          count         = groupEntities.size();
+        for (int i = groupEntities.size() - 1; i >= 0; i--) {
+            if (removeIds.contains(groupEntities[i].toString())) {
                 groupEntities.removeAt(i);
-                break;
             }
         }
-        item.insert("entities", groupEntities);
-        groups.insert(iter.key(), item);
+        if (groupEntities.size() != count) {
+            item.insert("entities", groupEntities);
+            iter.value() = item;
+        }
     }
-    m_config->setGroups(groups);
 
-    // remove entity from favorites
+    // remove entities from favorites
     QVariantMap profiles = m_config->getProfiles();
-    for (QVariantMap::const_iterator iter = profiles.begin(); iter != profiles.end(); ++iter) {
+    for (QVariantMap::iterator iter = profiles.begin(); iter != profiles.end(); ++iter) {
         QVariantMap  item            = iter.value().toMap();
         QVariantList profileEntities = item.value("favorites").toList();
-        for (int i = 0; i < profileEntities.length(); i++) {
-            if (profileEntities[i].toString() == entityId) {
+        int          count           = profileEntities.size();
+        for (int i = profileEntities.size() - 1; i >= 0; i--) {
+            if (removeIds.contains(profileEntities[i].toString())) {
                 profileEntities.removeAt(i);
-                break;
             }
         }
-        item.insert("favorites", profileEntities);
-        profiles.insert(iter.key(), item);
+        if (profileEntities.size() != count) {
+            item.insert("favorites", profileEntities);
+            iter.value() = item;
+        }
     }
-    m_config->setProfiles(profiles);
 
     // remove from config
-    // get the config
-    QVariantMap  c            = getConfig();
-    QVariantMap  entities     = c.value("entities").toMap();
-    QVariantList entitiesType = entities.value(eIface->type()).toList();
-
-    for (int i = 0; i < entitiesType.length(); i++) {
-        if (entitiesType[i].toMap().value("entity_id").toString() == entityId) {
-            entitiesType.removeAt(i);
-            qCDebug(CLASS_LC) << "4";
-            break;
+    QVariantMap entities = getConfig().value("entities").toMap();
+    for (const QString &type : removeTypes) {
+        QVariantList entitiesType = entities.value(type).toList();
+        for (int i = entitiesType.size() - 1; i >= 0; i--) {
+            if (removeIds.contains(entitiesType[i].toMap().value(Config::KEY_ENTITY_ID).toString())) {
+                entitiesType.removeAt(i);
+            }
         }
+        entities.insert(type, entitiesType);
+    }
+
+    // write the config back with one change
+    QVariantMap uiConfig;
+    uiConfig.insert("groups", groups);
+    uiConfig.insert("profiles", profiles);
+    QVariantMap patch;
+    patch.insert("entities", entities);
+    patch.insert("ui_config", uiConfig);
+    if (!m_config->patchConfig(patch)) {
+        errors.append(m_config->getError());
+        return false;
     }
 
-    // put entities back to config
-    entities.insert(eIface->type(), entitiesType);
-    c.insert("entities", entities);
-
-    delete eIface;
+    for (const QString &entityId : removeIds) {
+        QObject *entity = m_entities->get(entityId);
 
-    // write the config back
-    bool success = setConfig(c);
-    if (success) {
         // if it is a media player and playing, remove from mini media player
         m_entities->removeMediaplayersPlaying(entityId, true);
 
         // remove from database
         m_entities->remove(entityId);
-        return true;
-    } else {
-        return false;
+        delete entity;
     }
+
+    return true;
 }
 
 bool YioAPI::addIntegration(QVariantMap integration) {
@@ -393,15 +458,19 @@ bool YioAPI::removeIntegration(QString integrationId) {
 
     // unload all entities connected to the integration
     QList<EntityInterface *> entities = m_entities->getByIntegration(integrationType);
+    QStringList              entityIds;
     for (int i = 0; i < entities.length(); i++) {
-        // remove entity from config and database
         if (entities[i]->integration() == integrationId) {
-            if (!removeEntity(entities[i]->entity_id())) {
-                return false;
-            }
+            entityIds.append(entities[i]->entity_id());
         }
     }
 
+    // remove entities from config and database
+    QStringList errors;
+    if (!entityIds.isEmpty() && !removeEntities(entityIds, errors)) {
+        return false;
+    }
+
     // remove integration from database
     if (integration) {
         m_integrations->remove(integrationId);
@@ -537,19 +606,92 @@ void YioAPI::discoverNetworkServices(QString mdns) {
     }
 }
 
+void YioAPI::registerApiHandler(const QString &type, ApiHandler handler) {
+    if (m_apiHandlers.contains(type)) {
+        qCWarning(CLASS_LC) << "Replacing API handler for message type:" << type;
+    }
+    m_apiHandlers.insert(type, handler);
+}
+
+void YioAPI::registerApiHandlers() {
+    // system
+    registerApiHandler("button", &YioAPI::apiSystemButton);
+    registerApiHandler("reboot", &YioAPI::apiSystemReboot);
+    registerApiHandler("shutdown", &YioAPI::apiSystemShutdown);
+    registerApiHandler("subscribe_events", &YioAPI::apiSystemSubscribeToEvents);
+    registerApiHandler("unsubscribe_events", &YioAPI::apiSystemUnsubscribeFromEvents);
+    registerApiHandler("get_logs", &YioAPI::apiSystemGetLogs);
+    registerApiHandler("get_wake_latency", &YioAPI::apiSystemGetWakeLatency);
+
+    // config
+    registerApiHandler("get_config", &YioAPI::apiGetConfig);
+    registerApiHandler("set_config", &YioAPI::apiSetConfig);
+    registerApiHandler("patch_config", &YioAPI::apiPatchConfig);
+
+    // integrations
+    registerApiHandler("discover_integrations", &YioAPI::apiIntegrationsDiscover);
+    registerApiHandler("get_supported_integrations", &YioAPI::apiIntegrationsGetSupported);
+    registerApiHandler("get_loaded_integrations", &YioAPI::apiIntegrationsGetLoaded);
+    registerApiHandler("get_integrations_load", &YioAPI::apiIntegrationsGetLoad);
+    registerApiHandler("get_integration_setup_data", &YioAPI::apiIntegrationGetData);
+    registerApiHandler("add_integration", &YioAPI::apiIntegrationAdd);
+    registerApiHandler("update_integration", &YioAPI::apiIntegrationUpdate);
+    registerApiHandler("remove_integration", &YioAPI::apiIntegrationRemove);
+
+    // entities
+    registerApiHandler("get_supported_entities", &YioAPI::apiEntitiesGetSupported);
+    registerApiHandler("get_loaded_entities", &YioAPI::apiEntitiesGetLoaded);
+    registerApiHandler("get_available_entities", &YioAPI::apiEntitiesGetAvailable);
+    registerApiHandler("add_entity", &YioAPI::apiEntitiesAdd);
+    registerApiHandler("update_entity", &YioAPI::apiEntitiesUpdate);
+    registerApiHandler("remove_entity", &YioAPI::apiEntitiesRemove);
+    registerApiHandler("add_entities", &YioAPI::apiEntitiesAddBatch);
+    registerApiHandler("remove_entities", &YioAPI::apiEntitiesRemoveBatch);
+    registerApiHandler("subscribe_entities", &YioAPI::apiEntitiesSubscribe);
+    registerApiHandler("unsubscribe_entities", &YioAPI::apiEntitiesUnsubscribe);
+
+    // LOGS
+    registerApiHandler("subscribe_logs", &YioAPI::apiLogsSubscribe);
+    registerApiHandler("unsubscribe_logs", &YioAPI::apiLogsUnsubscribe);
+
+    // profiles
+    registerApiHandler("get_all_profiles", &YioAPI::apiProfilesGetAll);
+    registerApiHandler("set_profile", &YioAPI::apiProfilesSet);
+    registerApiHandler("add_profile", &YioAPI::apiProfilesAdd);
+    registerApiHandler("update_profile", &YioAPI::apiProfilesUpdate);
+    registerApiHandler("remove_profile", &YioAPI::apiProfilesRemove);
+
+    // pages
+    registerApiHandler("get_all_pages", &YioAPI::apiPagesGetAll);
+    registerApiHandler("add_page", &YioAPI::apiPagesAdd);
+    registerApiHandler("update_page", &YioAPI::apiPagesUpdate);
+    registerApiHandler("remove_page", &YioAPI::apiPagesRemove);
+
+    // groups
+    registerApiHandler("get_all_groups", &YioAPI::apiGroupsGetAll);
+    registerApiHandler("add_group", &YioAPI::apiGroupsAdd);
+    registerApiHandler("update_group", &YioAPI::apiGroupsUpdate);
+    registerApiHandler("remove_group", &YioAPI::apiGroupsRemove);
+
+    // settings
+    registerApiHandler("get_languages", &YioAPI::apiSettingsGetAllLanguages);
+    registerApiHandler("set_language", &YioAPI::apiSettingsSetLanguage);
+    registerApiHandler("set_auto_brightness", &YioAPI::apiSettingsSetAutoBrightness);
+    registerApiHandler("set_dark_mode", &YioAPI::apiSettingsSetDarkMode);
+}
+
 void YioAPI::onNewConnection() {
     QWebSocket *socket = m_server->nextPendingConnection();
 
     connect(socket, &QWebSocket::textMessageReceived, this, &YioAPI::processMessage);
+    connect(socket, &QWebSocket::binaryMessageReceived, this, &YioAPI::processBinaryMessage);
     connect(socket, &QWebSocket::disconnected, this, &YioAPI::onClientDisconnected);
 
     // send message to client after connected to authenticate
     QVariantMap map;
     map.insert("type", "auth_required");
-    QJsonDocument doc     = QJsonDocument::fromVariant(map);
-    QString       message = doc.toJson(QJsonDocument::JsonFormat::Compact);
-
-    socket->sendTextMessage(message);
+    // the client has not yet chosen a message encoding: always announce in JSON
+    sendToClient(socket, map);
     m_clients.insert(socket, false);
 }
 
@@ -569,140 +711,62 @@ void YioAPI::processMessage(QString message) {
             return;
         }
 
-        QVariantMap map  = doc.toVariant().toMap();
-        QString     type = map.value("type").toString();
-        int         id;
-
-        if (map.contains("id")) {
-            id = map.value("id").toInt();
-        }
-
-        if (type == "auth" && !m_clients[client]) {
-            /// Authentication
-            apiAuth(client, map);
-        } else if (m_clients[client]) {
-            if (type == "button") {
-                /// Button simulation through the api
-                apiSystemButton(id, map);
-            } else if (type == "reboot") {
-                /// Reboot
-                apiSystemReboot(client, id);
-            } else if (type == "shutdown") {
-                /// Shutdown
-                apiSystemShutdown(client, id);
-            } else if (type == "subscribe_events") {
-                /// Subscribe to events
-                apiSystemSubscribeToEvents(client, id);
-            } else if (type == "unsubscribe_events") {
-                /// Unsubscribe from events
-                apiSystemUnsubscribeFromEvents(client, id);
-            } else if (type == "get_config") {
-                /// Get config
-                apiGetConfig(client, id);
-            } else if (type == "set_config") {
-                /// Set config
-                apiSetConfig(client, id, map);
-            } else if (type == "discover_integrations") {
-                /// Discover integrations
-                apiIntegrationsDiscover(client, id);
-            } else if (type == "get_supported_integrations") {
-                /// Get supported integrations
-                apiIntegrationsGetSupported(client, id);
-            } else if (type == "get_loaded_integrations") {
-                /// Get loaded integrations
-                apiIntegrationsGetLoaded(client, id);
-            } else if (type == "get_integration_setup_data") {
-                /// Get data required to setup an integration
-                apiIntegrationGetData(client, id, map);
-            } else if (type == "add_integration") {
-                /// Add a new integration
-                apiIntegrationAdd(client, id, map);
-            } else if (type == "update_integration") {
-                /// Update an integration
-                apiIntegrationUpdate(client, id, map);
-            } else if (type == "remove_integration") {
-                /// Remove an integration
-                apiIntegrationRemove(client, id, map);
-            } else if (type == "get_supported_entities") {
-                /// Get supported entities
-                apiEntitiesGetSupported(client, id);
-            } else if (type == "get_loaded_entities") {
-                /// Get loaded entities
-                apiEntitiesGetLoaded(client, id);
-            } else if (type == "get_available_entities") {
-                /// Get available entities from integrations
-                apiEntitiesGetAvailable(client, id);
-            } else if (type == "add_entity") {
-                /// Get available entities from integrations
-                apiEntitiesAdd(client, id, map);
-            } else if (type == "update_entity") {
-                /// Get available entities from integrations
-                apiEntitiesUpdate(client, id, map);
-            } else if (type == "remove_entity") {
-                /// Get available entities from integrations
-                apiEntitiesRemove(client, id, map);
-            } else if (type == "get_all_profiles") {
-                /// Get all profiles
-                apiProfilesGetAll(client, id);
-            } else if (type == "set_profile") {
-                /// Set current profile
-                apiProfilesSet(client, id, map);
-            } else if (type == "add_profile") {
-                /// Add new profile
-                apiProfilesAdd(client, id, map);
-            } else if (type == "update_profile") {
-                /// Update a profile
-                apiProfilesUpdate(client, id, map);
-            } else if (type == "remove_profile") {
-                /// Remove a profile
-                apiProfilesRemove(client, id, map);
-            } else if (type == "get_all_pages") {
-                /// Get all pages
-                apiPagesGetAll(client, id);
-            } else if (type == "add_page") {
-                /// Add a page
-                apiPagesAdd(client, id, map);
-            } else if (type == "update_page") {
-                /// Update a page
-                apiPagesUpdate(client, id, map);
-            } else if (type == "remove_page") {
-                /// Remove a page
-                apiPagesRemove(client, id, map);
-            } else if (type == "get_all_groups") {
-                /// Get all groups
-                apiGroupsGetAll(client, id);
-            } else if (type == "add_group") {
-                /// Add a group
-                apiGroupsAdd(client, id, map);
-            } else if (type == "update_group") {
-                /// Update a group
-                apiGroupsUpdate(client, id, map);
-            } else if (type == "remove_group") {
-                /// Remove a group
-                apiGroupsRemove(client, id, map);
-            } else if (type == "get_languages") {
-                /// Get all languages
-                apiSettingsGetAllLanguages(client, id);
-            } else if (type == "set_language") {
-                /// Set a languages
-                apiSettingsSetLanguage(client, id, map);
-            } else if (type == "set_auto_brightness") {
-                /// Set auto brightness
-                apiSettingsSetAutoBrightness(client, id, map);
-            } else if (type == "set_dark_mode") {
-                /// Set dark mode
-                apiSettingsSetDarkMode(client, id, map);
-            }
+        dispatchMessage(client, doc.object());
+    }
+}
+
+void YioAPI::processBinaryMessage(QByteArray message) {
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+
+    if (client) {
+        // binary frames are CBOR encoded messages with the same structure as the JSON messages
+        QCborStreamReader reader(message);
+        if (!reader.isMap()) {
+            qCWarning(CLASS_LC) << "CBOR error: message is not a map";
+            return;
+        }
+        QJsonObject msg = readCborValue(&reader).toObject();
+        if (reader.lastError() != QCborError::NoError) {
+            qCWarning(CLASS_LC) << "CBOR error:" << reader.lastError().toString();
+            return;
+        }
+
+        // a client sending binary messages gets binary responses
+        m_binaryClients.insert(client);
+
+        dispatchMessage(client, msg);
+    }
+}
 
+void YioAPI::dispatchMessage(QWebSocket *client, const QJsonObject &msg) {
+    QString type = msg.value("type").toString();
+    int     id   = msg.value("id").toInt();
+
+    if (type == "auth" && !m_clients.value(client)) {
+        /// Authentication
+        apiAuth(client, msg);
+    } else if (m_clients.value(client)) {
+        ApiHandler handler = m_apiHandlers.value(type);
+        if (handler) {
+            (this->*handler)(client, id, msg);
         } else {
-            QVariantMap response;
-            qCWarning(CLASS_LC) << "Client not authenticated";
-            response.insert("type", "auth_error");
-            response.insert("message", "Please authenticate");
-            QJsonDocument json = QJsonDocument::fromVariant(response);
-            client->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
-            client->disconnect();
+            qCWarning(CLASS_LC) << "Unsupported message type:" << type;
         }
+    } else {
+        QVariantMap response;
+        qCWarning(CLASS_LC) << "Client not authenticated";
+        response.insert("type", "auth_error");
+        response.insert("message", "Please authenticate");
+        sendToClient(client, response);
+        client->disconnect();
+    }
+}
+
+void YioAPI::sendToClient(QWebSocket *client, const QVariantMap &message) {
+    if (m_binaryClients.contains(client)) {
+        client->sendBinaryMessage(QCborMap::fromVariantMap(message).toCborValue().toCbor());
+    } else {
+        client->sendTextMessage(QJsonDocument::fromVariant(message).toJson(QJsonDocument::JsonFormat::Compact));
     }
 }
 
@@ -713,19 +777,450 @@ void YioAPI::onClientDisconnected() {
         client->close();
         qCDebug(CLASS_LC) << "Client closed" << client;
         m_clients.remove(client);
+        m_binaryClients.remove(client);
+        m_eventSubscribers.remove(client);
+        m_entitySubscribers.remove(client);
+        if (m_logSubscribers.remove(client) > 0 && m_logSubscribers.isEmpty()) {
+            Logger::getInstance()->setStreamEnabled(false);
+        }
         client->deleteLater();
         qCDebug(CLASS_LC) << "Client removed";
     }
 }
 
-void YioAPI::subscribeOnSignalEvent(const QString &event) {
-    qCDebug(CLASS_LC) << "Sending message to all subscribed clients";
+int YioAPI::eventTopics(const QJsonArray &topics) {
+    static const QHash<QString, int> TOPICS = {{"config", TOPIC_CONFIG},
+                                               {"entities", TOPIC_ENTITIES},
+                                               {"battery", TOPIC_BATTERY},
+                                               {"buttons", TOPIC_BUTTONS},
+                                               {"standby", TOPIC_STANDBY}};
 
-    for (int i = 0; i < m_subscribed_clients.length(); i++) {
-        QVariantMap response;
-        response.insert("event", event);
-        QJsonDocument json = QJsonDocument::fromVariant(response);
-        m_subscribed_clients[i]->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
+    int mask = 0;
+    for (const QJsonValue &topic : topics) {
+        mask |= TOPICS.value(topic.toString(), 0);
+    }
+    return mask;
+}
+
+void YioAPI::connectEventSources() {
+    if (m_eventSourcesConnected) {
+        return;
+    }
+    m_eventSourcesConnected = true;
+
+    // config
+    connect(m_config, &Config::configChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "config_changed"); });
+    connect(m_config, &Config::settingsChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "settings_changed"); });
+    connect(m_config, &Config::profileIdChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "profileId_changed"); });
+    connect(m_config, &Config::profileFavoritesChanged, this,
+            [=]() { publishEvent(TOPIC_CONFIG, "profileFavorites_changed"); });
+    connect(m_config, &Config::profilesChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "profiles_changed"); });
+    connect(m_config, &Config::uiConfigChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "uiConfig_changed"); });
+    connect(m_config, &Config::pagesChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "pages_changed"); });
+    connect(m_config, &Config::groupsChanged, this, [=]() { publishEvent(TOPIC_CONFIG, "groups_changed"); });
+
+    // entities
+    connect(m_entities, &Entities::entitiesLoaded, this, [=]() { publishEvent(TOPIC_ENTITIES, "entities_loaded"); });
+    connect(m_entities, &Entities::mediaplayersPlayingChanged, this,
+            [=]() { publishEvent(TOPIC_ENTITIES, "mediaplayersPlaying_changed"); });
+
+    // battery
+    BatteryFuelGauge *battery = HardwareFactory::instance()->getBatteryFuelGauge();
+    connect(battery, &BatteryFuelGauge::levelChanged, this,
+            [=]() { publishEvent(TOPIC_BATTERY, "level_changed", {{"level", battery->getLevel()}}); });
+    connect(battery, &BatteryFuelGauge::isChargingChanged, this, [=]() {
+        publishEvent(TOPIC_BATTERY, "isCharging_changed", {{"isCharging", battery->getIsCharging()}});
+    });
+    connect(battery, &BatteryFuelGauge::healthChanged, this,
+            [=]() { publishEvent(TOPIC_BATTERY, "health_changed", {{"health", battery->getHealth()}}); });
+    connect(battery, &BatteryFuelGauge::lowBattery, this, [=]() { publishEvent(TOPIC_BATTERY, "low_battery"); });
+    connect(battery, &BatteryFuelGauge::criticalLowBattery, this,
+            [=]() { publishEvent(TOPIC_BATTERY, "critical_low_battery"); });
+    connect(battery, &BatteryFuelGauge::chargingDone, this, [=]() { publishEvent(TOPIC_BATTERY, "charging_done"); });
+
+    // buttons
+    ButtonHandler *buttonHandler = ButtonHandler::getInstance();
+    if (buttonHandler) {
+        QMetaEnum buttons = QMetaEnum::fromType<ButtonHandler::Buttons>();
+        connect(buttonHandler, &ButtonHandler::buttonPressed, this, [=](int button) {
+            publishEvent(TOPIC_BUTTONS, "button_pressed", {{"button", buttons.valueToKey(button)}});
+        });
+        connect(buttonHandler, &ButtonHandler::buttonReleased, this, [=](int button) {
+            publishEvent(TOPIC_BUTTONS, "button_released", {{"button", buttons.valueToKey(button)}});
+        });
+    } else {
+        qCWarning(CLASS_LC) << "Button handler not available: no button events";
+    }
+
+    // standby
+    StandbyControl *standbyControl = StandbyControl::getInstance();
+    if (standbyControl) {
+        connect(standbyControl, &StandbyControl::modeChanged, this,
+                [=]() { publishEvent(TOPIC_STANDBY, "mode_changed", {{"mode", standbyControl->mode()}}); });
+    } else {
+        qCWarning(CLASS_LC) << "Standby control not available: no standby events";
+    }
+}
+
+void YioAPI::publishEvent(EventTopic topic, const QString &event, const QVariantMap &data) {
+    if (m_eventSubscribers.isEmpty()) {
+        return;
+    }
+
+    m_pendingEvents.append({static_cast<int>(topic), event, data});
+    if (!m_eventTimer->isActive()) {
+        m_eventTimer->start();
+    }
+}
+
+void YioAPI::onEventTimeout() {
+    QList<PendingEvent> events;
+    events.swap(m_pendingEvents);
+
+    // every event is serialized at most once per encoding and shared between all clients
+    QVector<QByteArray> jsonEvents(events.size());
+    QVector<QByteArray> cborEvents(events.size());
+
+    for (auto subscriber = m_eventSubscribers.cbegin(); subscriber != m_eventSubscribers.cend(); ++subscriber) {
+        QWebSocket *client = subscriber.key();
+        bool        binary = m_binaryClients.contains(client);
+
+        QList<QByteArray> messages;
+        for (int i = 0; i < events.size(); i++) {
+            const PendingEvent &event = events[i];
+            if (!(event.topic & subscriber->topics)) {
+                continue;
+            }
+            QByteArray &serialized = binary ? cborEvents[i] : jsonEvents[i];
+            if (serialized.isEmpty() && binary) {
+                QCborMap message;
+                message.insert(QLatin1String("type"), QLatin1String("event"));
+                message.insert(QLatin1String("event"), event.event);
+                if (!event.data.isEmpty()) {
+                    message.insert(QLatin1String("data"), QCborMap::fromVariantMap(event.data));
+                }
+                serialized = message.toCborValue().toCbor();
+            } else if (serialized.isEmpty()) {
+                QJsonObject message;
+                message.insert("type", "event");
+                message.insert("event", event.event);
+                if (!event.data.isEmpty()) {
+                    message.insert("data", QJsonObject::fromVariantMap(event.data));
+                }
+                serialized = QJsonDocument(message).toJson(QJsonDocument::Compact);
+            }
+            messages.append(serialized);
+        }
+
+        if (messages.isEmpty()) {
+            continue;
+        }
+
+        if (subscriber->batch) {
+            // {"type": "events", "events": [...]} assembled from the already serialized events
+            QByteArray batch;
+            if (binary) {
+                batch.append('\xA2');  // map with 2 pairs
+                batch.append('\x64').append("type");
+                batch.append('\x66').append("events");
+                batch.append('\x66').append("events");
+                appendCborArrayHeader(&batch, messages.size());
+                for (const QByteArray &message : messages) {
+                    batch.append(message);
+                }
+                client->sendBinaryMessage(batch);
+            } else {
+                batch.append("{\"type\":\"events\",\"events\":[");
+                batch.append(messages.join(','));
+                batch.append("]}");
+                client->sendTextMessage(QString::fromUtf8(batch));
+            }
+        } else {
+            for (const QByteArray &message : messages) {
+                if (binary) {
+                    client->sendBinaryMessage(message);
+                } else {
+                    client->sendTextMessage(QString::fromUtf8(message));
+                }
+            }
+        }
+    }
+}
+
+void YioAPI::onEntityChanged(Entity *entity, int attrIndex) {
+    if (m_entitySubscribers.isEmpty()) {
+        return;
+    }
+
+    m_changedEntities[entity->entity_id()].insert(attrIndex);
+    // the timer might wait longer for a throttled client
+    if (!m_entityFrameTimer->isActive() || m_entityFrameTimer->remainingTime() > ENTITY_FRAME_INTERVAL) {
+        m_entityFrameTimer->start(ENTITY_FRAME_INTERVAL);
+    }
+}
+
+void YioAPI::onEntityFrameTimeout() {
+    QHash<QString, QSet<int>> changedEntities;
+    changedEntities.swap(m_changedEntities);
+
+    qint64 now      = QDateTime::currentMSecsSinceEpoch();
+    qint64 nextSend = -1;  // ms until the first throttled client may get its next update
+
+    // the changed attribute values are read once per frame and shared between all clients
+    QHash<QString, QHash<int, QVariant>> values;
+
+    for (auto subscriber = m_entitySubscribers.begin(); subscriber != m_entitySubscribers.end(); ++subscriber) {
+        for (auto changed = changedEntities.cbegin(); changed != changedEntities.cend(); ++changed) {
+            if (subscriber->entityIds.isEmpty() || subscriber->entityIds.contains(changed.key())) {
+                subscriber->pending[changed.key()].unite(changed.value());
+            }
+        }
+
+        if (subscriber->pending.isEmpty()) {
+            continue;
+        }
+        qint64 wait = subscriber->lastSent + subscriber->throttle - now;
+        if (wait > 0) {
+            nextSend = nextSend < 0 ? wait : qMin(nextSend, wait);
+            continue;
+        }
+
+        // the frame is built directly in the encoding of the client
+        QWebSocket *client = subscriber.key();
+        bool        binary = m_binaryClients.contains(client);
+        QCborArray  cborEntities;
+        QJsonArray  jsonEntities;
+        for (auto pending = subscriber->pending.cbegin(); pending != subscriber->pending.cend(); ++pending) {
+            Entity *entity = qobject_cast<Entity *>(m_entities->get(pending.key()));
+            if (!entity) {
+                continue;
+            }
+
+            QCborMap              cborAttributes;
+            QJsonObject           jsonAttributes;
+            QHash<int, QVariant> &entityValues = values[pending.key()];
+            for (int attrIndex : pending.value()) {
+                if (!entityValues.contains(attrIndex)) {
+                    entityValues.insert(attrIndex, entity->getAttrValue(attrIndex));
+                }
+                QString name = entity->getAttrName(attrIndex).toLower();
+                if (binary) {
+                    cborAttributes.insert(name, QCborValue::fromVariant(entityValues.value(attrIndex)));
+                } else {
+                    jsonAttributes.insert(name, QJsonValue::fromVariant(entityValues.value(attrIndex)));
+                }
+            }
+
+            if (binary) {
+                QCborMap update;
+                update.insert(QLatin1String("entity_id"), pending.key());
+                update.insert(QLatin1String("attributes"), cborAttributes);
+                cborEntities.append(update);
+            } else {
+                QJsonObject update;
+                update.insert("entity_id", pending.key());
+                update.insert("attributes", jsonAttributes);
+                jsonEntities.append(update);
+            }
+        }
+        subscriber->pending.clear();
+        subscriber->lastSent = now;
+
+        if (!cborEntities.isEmpty()) {
+            QCborMap message;
+            message.insert(QLatin1String("type"), QLatin1String("entities_changed"));
+            message.insert(QLatin1String("entities"), cborEntities);
+            client->sendBinaryMessage(message.toCborValue().toCbor());
+        } else if (!jsonEntities.isEmpty()) {
+            QJsonObject message;
+            message.insert("type", "entities_changed");
+            message.insert("entities", jsonEntities);
+            client->sendTextMessage(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
+        }
+    }
+
+    // throttled clients still waiting for their next update, the timer is armed once for the earliest of them
+    if (nextSend > 0 && !m_entityFrameTimer->isActive()) {
+        m_entityFrameTimer->start(static_cast<int>(nextSend));
+    }
+}
+
+void YioAPI::onLogFrameTimeout() {
+    Logger *logger = Logger::getInstance();
+    if (logger == nullptr) {
+        return;
+    }
+
+    // every log message is serialized at most once per encoding and shared between all clients
+    QHash<quint64, QByteArray> jsonMessages;
+    QHash<quint64, QByteArray> cborMessages;
+    bool                       pendingMessages = false;
+
+    for (auto subscriber = m_logSubscribers.begin(); subscriber != m_logSubscribers.end(); ++subscriber) {
+        QWebSocket *client = subscriber.key();
+        bool        binary = m_binaryClients.contains(client);
+
+        QVector<Logger::StreamEntry> entries;
+        subscriber->lost += logger->readStream(&subscriber->cursor, LOG_FRAME_SIZE, subscriber->logLevel,
+                                               subscriber->categories, &entries);
+        if (entries.size() >= LOG_FRAME_SIZE) {
+            pendingMessages = true;  // the rest follows with the next frame
+        }
+        if (entries.isEmpty() && subscriber->lost == 0) {
+            continue;
+        }
+
+        QHash<quint64, QByteArray> &serialized = binary ? cborMessages : jsonMessages;
+        QList<QByteArray>           messages;
+        for (const Logger::StreamEntry &entry : entries) {
+            auto message = serialized.find(entry.sequence);
+            if (message == serialized.end() && binary) {
+                QCborMap map;
+                map.insert(QLatin1String("type"), static_cast<int>(entry.type));
+                map.insert(QLatin1String("cat"), entry.category);
+                map.insert(QLatin1String("time"), entry.timestamp);
+                map.insert(QLatin1String("msg"), entry.message);
+                if (!entry.sourcePosition.isEmpty()) {
+                    map.insert(QLatin1String("src"), entry.sourcePosition);
+                }
+                message = serialized.insert(entry.sequence, map.toCborValue().toCbor());
+            } else if (message == serialized.end()) {
+                QJsonObject map;
+                map.insert("type", static_cast<int>(entry.type));
+                map.insert("cat", entry.category);
+                map.insert("time", entry.timestamp);
+                map.insert("msg", entry.message);
+                if (!entry.sourcePosition.isEmpty()) {
+                    map.insert("src", entry.sourcePosition);
+                }
+                message = serialized.insert(entry.sequence, QJsonDocument(map).toJson(QJsonDocument::Compact));
+            }
+            messages.append(message.value());
+        }
+
+        // {"type": "logs", "lost": n, "logs": [...]} assembled from the already serialized messages
+        QByteArray frame;
+        if (binary) {
+            frame.append('\xA3');  // map with 3 pairs
+            frame.append('\x64').append("type");
+            frame.append('\x64').append("logs");
+            frame.append('\x64').append("lost");
+            frame.append(QCborValue(static_cast<qint64>(subscriber->lost)).toCbor());
+            frame.append('\x64').append("logs");
+            appendCborArrayHeader(&frame, messages.size());
+            for (const QByteArray &message : messages) {
+                frame.append(message);
+            }
+            client->sendBinaryMessage(frame);
+        } else {
+            frame.append("{\"type\":\"logs\",\"lost\":").append(QByteArray::number(subscriber->lost));
+            frame.append(",\"logs\":[");
+            frame.append(messages.join(','));
+            frame.append("]}");
+            client->sendTextMessage(QString::fromUtf8(frame));
+        }
+        subscriber->lost = 0;
+    }
+
+    if (pendingMessages && !m_logFrameTimer->isActive()) {
+        m_logFrameTimer->start();
+    }
+}
+
+void YioAPI::appendCborArrayHeader(QByteArray *data, int count) {
+    if (count < 24) {
+        data->append(static_cast<char>(0x80 | count));
+    } else if (count < 0x100) {
+        data->append('\x98').append(static_cast<char>(count));
+    } else if (count < 0x10000) {
+        data->append('\x99').append(static_cast<char>(count >> 8)).append(static_cast<char>(count));
+    } else {
+        data->append('\x9A')
+            .append(static_cast<char>(count >> 24))
+            .append(static_cast<char>(count >> 16))
+            .append(static_cast<char>(count >> 8))
+            .append(static_cast<char>(count));
+    }
+}
+
+QJsonValue YioAPI::readCborValue(QCborStreamReader *reader) {
+    switch (reader->type()) {
+        case QCborStreamReader::UnsignedInteger:
+        case QCborStreamReader::NegativeInteger: {
+            qint64 value = reader->toInteger();
+            reader->next();
+            return QJsonValue(value);
+        }
+        case QCborStreamReader::ByteArray: {
+            QByteArray value;
+            auto       chunk = reader->readByteArray();
+            for (; chunk.status == QCborStreamReader::Ok; chunk = reader->readByteArray()) {
+                value.append(chunk.data);
+            }
+            return QString::fromLatin1(value.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+        }
+        case QCborStreamReader::String: {
+            QString value;
+            auto    chunk = reader->readString();
+            for (; chunk.status == QCborStreamReader::Ok; chunk = reader->readString()) {
+                value.append(chunk.data);
+            }
+            return value;
+        }
+        case QCborStreamReader::Array: {
+            QJsonArray array;
+            reader->enterContainer();
+            while (reader->lastError() == QCborError::NoError && reader->hasNext()) {
+                array.append(readCborValue(reader));
+            }
+            if (reader->lastError() == QCborError::NoError) {
+                reader->leaveContainer();
+            }
+            return array;
+        }
+        case QCborStreamReader::Map: {
+            QJsonObject object;
+            reader->enterContainer();
+            while (reader->lastError() == QCborError::NoError && reader->hasNext()) {
+                QJsonValue key = readCborValue(reader);
+                object.insert(key.isString() ? key.toString() : key.toVariant().toString(), readCborValue(reader));
+            }
+            if (reader->lastError() == QCborError::NoError) {
+                reader->leaveContainer();
+            }
+            return object;
+        }
+        case QCborStreamReader::Tag:
+            // tags are ignored, the tagged value follows
+            reader->next();
+            return readCborValue(reader);
+        case QCborStreamReader::False:
+        case QCborStreamReader::True: {
+            bool value = reader->toBool();
+            reader->next();
+            return value;
+        }
+        case QCborStreamReader::Float16: {
+            double value = reader->toFloat16();
+            reader->next();
+            return value;
+        }
+        case QCborStreamReader::Float: {
+            double value = reader->toFloat();
+            reader->next();
+            return value;
+        }
+        case QCborStreamReader::Double: {
+            double value = reader->toDouble();
+            reader->next();
+            return value;
+        }
+        case QCborStreamReader::Invalid:
+            return QJsonValue(QJsonValue::Undefined);
+        default:
+            // null, undefined and other simple types
+            reader->next();
+            return QJsonValue();
     }
 }
 
@@ -737,12 +1232,10 @@ void YioAPI::apiSendResponse(QWebSocket *client, const int &id, const bool &succ
     response.insert("success", success);
     response.insert("type", "result");
 
-    QJsonDocument json = QJsonDocument::fromVariant(response);
-
     if (client) {
         if (m_clients.contains(client)) {
             if (client->isValid()) {
-                client->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
+                sendToClient(client, response);
                 qCDebug(CLASS_LC) << "Sent response to client" << client;
             }
         }
@@ -750,22 +1243,25 @@ void YioAPI::apiSendResponse(QWebSocket *client, const int &id, const bool &succ
     //    qCDebug(CLASS_LC) << "Response sent to client:" << client << "id:" << id << "response:" << response;
 }
 
-void YioAPI::apiAuth(QWebSocket *client, const QVariantMap &map) {
+void YioAPI::apiAuth(QWebSocket *client, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Client authenticating:" << m_clients[client];
 
     QVariantMap response;
 
-    if (map.contains("token")) {
+    if (msg.contains("token")) {
         qCDebug(CLASS_LC) << "Has token";
 
-        // QByteArray hash = QCryptographicHash::hash(map.value("token").toString().toLocal8Bit(),
+        // QByteArray hash = QCryptographicHash::hash(msg.value("token").toString().toLocal8Bit(),
         //                                            QCryptographicHash::Sha512);
 
-        if (map.value("token").toString() == m_token) {
+        if (msg.value("token").toString() == m_token) {
             qDebug(CLASS_LC) << "Token OK";
+            // optional encoding negotiation for clients which authenticate with a JSON message
+            if (msg.value("encoding").toString() == "cbor") {
+                m_binaryClients.insert(client);
+            }
             response.insert("type", "auth_ok");
-            QJsonDocument json = QJsonDocument::fromVariant(response);
-            client->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
+            sendToClient(client, response);
 
             m_clients[client] = true;
 
@@ -775,24 +1271,23 @@ void YioAPI::apiAuth(QWebSocket *client, const QVariantMap &map) {
             qCWarning(CLASS_LC) << "Token NOT OK";
             response.insert("type", "auth_error");
             response.insert("message", "Invalid token");
-            QJsonDocument json = QJsonDocument::fromVariant(response);
-            client->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
+            sendToClient(client, response);
             client->disconnect();
         }
     } else {
         qCWarning(CLASS_LC) << "No token";
         response.insert("type", "auth_error");
         response.insert("message", "Token needed");
-        QJsonDocument json = QJsonDocument::fromVariant(response);
-        client->sendTextMessage(json.toJson(QJsonDocument::JsonFormat::Compact));
+        sendToClient(client, response);
         client->disconnect();
     }
 }
 
-void YioAPI::apiSystemButton(const int &id, const QVariantMap &map) {
-    Q_UNUSED(id);
-    QString buttonName   = map["name"].toString();
-    QString buttonAction = map["action"].toString();
+void YioAPI::apiSystemButton(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(client)
+    Q_UNUSED(id)
+    QString buttonName   = msg.value("name").toString();
+    QString buttonAction = msg.value("action").toString();
     qDebug(CLASS_LC) << "Button simulation:" << buttonName << "," << buttonAction;
 
     if (buttonAction == "pressed") {
@@ -802,75 +1297,108 @@ void YioAPI::apiSystemButton(const int &id, const QVariantMap &map) {
     }
 }
 
-void YioAPI::apiSystemReboot(QWebSocket *client, const int &id) {
-    Q_UNUSED(id);
+void YioAPI::apiSystemReboot(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(id)
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for reboot" << client;
+    m_config->flush();
     Launcher launcher;
     launcher.launch("reboot");
 }
 
-void YioAPI::apiSystemShutdown(QWebSocket *client, const int &id) {
-    Q_UNUSED(id);
+void YioAPI::apiSystemShutdown(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(id)
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for shutdown" << client;
     StandbyControl::getInstance()->shutdown();
 }
 
-void YioAPI::apiSystemSubscribeToEvents(QWebSocket *client, const int &id) {
+void YioAPI::apiSystemSubscribeToEvents(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for subscribe to events" << client;
     QVariantMap response;
 
-    if (m_subscribed_clients.contains(client)) {
-        apiSendResponse(client, id, false, response);
-        return;
+    // without topics only config events are sent, as before topic filtering was available
+    int topics = TOPIC_CONFIG;
+    if (msg.contains("topics")) {
+        topics = eventTopics(msg.value("topics").toArray());
+        if (topics == 0) {
+            response.insert("error", "No valid topics");
+            apiSendResponse(client, id, false, response);
+            return;
+        }
     }
 
-    // add client to the subscribed client list
-    m_subscribed_clients.append(client);
-
-    // connect to signals
-    m_context = new QObject(this);
+    connectEventSources();
 
-    QObject::connect(m_config, &Config::configChanged, m_context, [=]() { subscribeOnSignalEvent("config_changed"); });
-    QObject::connect(m_config, &Config::settingsChanged, m_context,
-                     [=]() { subscribeOnSignalEvent("settings_changed"); });
-    QObject::connect(m_config, &Config::profileIdChanged, m_context,
-                     [=]() { subscribeOnSignalEvent("profileId_changed"); });
-    QObject::connect(m_config, &Config::profileFavoritesChanged, m_context,
-                     [=]() { subscribeOnSignalEvent("profileFavorites_changed"); });
-    QObject::connect(m_config, &Config::profilesChanged, m_context,
-                     [=]() { subscribeOnSignalEvent("profiles_changed"); });
-    QObject::connect(m_config, &Config::uiConfigChanged, m_context,
-                     [=]() { subscribeOnSignalEvent("uiConfig_changed"); });
-    QObject::connect(m_config, &Config::pagesChanged, m_context, [=]() { subscribeOnSignalEvent("pages_changed"); });
-    QObject::connect(m_config, &Config::groupsChanged, m_context, [=]() { subscribeOnSignalEvent("groups_changed"); });
+    // subscribing again changes the subscription of the client
+    m_eventSubscribers.insert(client, {topics, msg.value("batch").toBool()});
 
     apiSendResponse(client, id, true, response);
 }
 
-void YioAPI::apiSystemUnsubscribeFromEvents(QWebSocket *client, const int &id) {
+void YioAPI::apiSystemUnsubscribeFromEvents(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for unsubscribe from events" << client;
     QVariantMap response;
 
-    if (!m_subscribed_clients.contains(client)) {
+    apiSendResponse(client, id, m_eventSubscribers.remove(client) > 0, response);
+}
+
+void YioAPI::apiSystemGetLogs(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    qCDebug(CLASS_LC) << "Request for get logs" << client;
+    QVariantMap response;
+
+    Logger *logger = Logger::getInstance();
+    if (logger == nullptr || !logger->binaryEnabled()) {
+        response.insert("error", "Binary log files are not enabled");
         apiSendResponse(client, id, false, response);
         return;
     }
 
-    QObject::disconnect(m_context);
-    m_context->deleteLater();
+    // from and to are unix time in ms, messages are returned from the oldest, continue with from = last time + 1
+    qint64      from = static_cast<qint64>(msg.value("from").toDouble(0));
+    qint64      to = static_cast<qint64>(msg.value("to").toDouble(QDateTime::currentMSecsSinceEpoch()));
+    int         level = logger->toMsgType(msg.value("level").toString("DEBUG"));
+    int         limit = msg.value("limit").toInt(1000);
+    QStringList categories;
+    for (const QJsonValue &category : msg.value("categories").toArray()) {
+        categories.append(category.toString());
+    }
 
-    for (int i = 0; i < m_subscribed_clients.length(); i++) {
-        if (m_subscribed_clients[i] == client) {
-            m_subscribed_clients.removeAt(i);
-            apiSendResponse(client, id, true, response);
+    // the query runs on the thread pool, the client might be gone when it has finished
+    QPointer<QWebSocket> socket(client);
+    logger->getLogs(from, to, level, categories, limit, this, [=](const QJsonArray &logs) {
+        if (socket.isNull()) {
             return;
         }
+        QVariantMap result;
+        result.insert("logs", logs.toVariantList());
+        result.insert("more", logs.count() >= limit);
+        apiSendResponse(socket, id, true, result);
+    });
+}
+
+void YioAPI::apiSystemGetWakeLatency(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    qCDebug(CLASS_LC) << "Request for get wake latency" << client;
+    QVariantMap response;
+
+    WakeLatency *wakeLatency = WakeLatency::getInstance();
+    if (wakeLatency == nullptr) {
+        response.insert("error", "Wake latency not available");
+        apiSendResponse(client, id, false, response);
+        return;
     }
 
-    apiSendResponse(client, id, false, response);
+    // histograms by phase in ms since the wake event, "reset": true starts new histograms after this response
+    response.insert("wake_latency", wakeLatency->statistics());
+    if (msg.value("reset").toBool()) {
+        wakeLatency->reset();
+    }
+    apiSendResponse(client, id, true, response);
 }
 
-void YioAPI::apiGetConfig(QWebSocket *client, const int &id) {
+void YioAPI::apiGetConfig(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get config" << client;
 
     QVariantMap response;
@@ -884,11 +1412,11 @@ void YioAPI::apiGetConfig(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiSetConfig(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiSetConfig(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for set config" << client;
 
     QVariantMap response;
-    QVariantMap config = map.value("config").toMap();
+    QVariantMap config = msg.value("config").toObject().toVariantMap();
 
     if (setConfig(config)) {
         apiSendResponse(client, id, true, response);
@@ -897,7 +1425,22 @@ void YioAPI::apiSetConfig(QWebSocket *client, const int &id, const QVariantMap &
     }
 }
 
-void YioAPI::apiIntegrationsDiscover(QWebSocket *client, const int &id) {
+void YioAPI::apiPatchConfig(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    qCDebug(CLASS_LC) << "Request for patch config" << client;
+
+    QVariantMap response;
+    QVariantMap patch = msg.value("patch").toObject().toVariantMap();
+
+    if (m_config->patchConfig(patch)) {
+        apiSendResponse(client, id, true, response);
+    } else {
+        response.insert("error", m_config->getError());
+        apiSendResponse(client, id, false, response);
+    }
+}
+
+void YioAPI::apiIntegrationsDiscover(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for discover integrations" << client;
 
     QTimer * timeOutTimer = new QTimer();
@@ -944,7 +1487,8 @@ void YioAPI::apiIntegrationsDiscover(QWebSocket *client, const int &id) {
     timeOutTimer->start(10000);
 }
 
-void YioAPI::apiIntegrationsGetSupported(QWebSocket *client, const int &id) {
+void YioAPI::apiIntegrationsGetSupported(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get supported integrations" << client;
 
     QVariantMap response;
@@ -957,7 +1501,8 @@ void YioAPI::apiIntegrationsGetSupported(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiIntegrationsGetLoaded(QWebSocket *client, const int &id) {
+void YioAPI::apiIntegrationsGetLoaded(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get supported integrations" << client;
 
     QVariantMap response;
@@ -979,8 +1524,17 @@ void YioAPI::apiIntegrationsGetLoaded(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiIntegrationGetData(QWebSocket *client, const int &id, const QVariantMap &map) {
-    QString integration = map.value("integration").toString();
+void YioAPI::apiIntegrationsGetLoad(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
+    qCDebug(CLASS_LC) << "Request for get integrations load" << client;
+
+    QVariantMap response;
+    response.insert("integrations", m_integrations->scheduler()->statistics());
+    apiSendResponse(client, id, true, response);
+}
+
+void YioAPI::apiIntegrationGetData(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    QString integration = msg.value("integration").toString();
     qCDebug(CLASS_LC) << "Request for get integration" << integration << "setup data" << client;
 
     QVariantMap response;
@@ -1001,24 +1555,24 @@ void YioAPI::apiIntegrationGetData(QWebSocket *client, const int &id, const QVar
     apiSendResponse(client, id, success, response);
 }
 
-void YioAPI::apiIntegrationAdd(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiIntegrationAdd(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for add integration" << client;
 
     QVariantMap response;
 
-    if (addIntegration(map.value("config").toMap())) {
+    if (addIntegration(msg.value("config").toObject().toVariantMap())) {
         apiSendResponse(client, id, true, response);
     } else {
         apiSendResponse(client, id, false, response);
     }
 }
 
-void YioAPI::apiIntegrationUpdate(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiIntegrationUpdate(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for update integration" << client;
 
     QVariantMap response;
 
-    if (updateIntegration(map.value("config").toMap())) {
+    if (updateIntegration(msg.value("config").toObject().toVariantMap())) {
         response.insert("message", "Restart the remote to update the integration.");
         apiSendResponse(client, id, true, response);
     } else {
@@ -1026,8 +1580,8 @@ void YioAPI::apiIntegrationUpdate(QWebSocket *client, const int &id, const QVari
     }
 }
 
-void YioAPI::apiIntegrationRemove(QWebSocket *client, const int &id, const QVariantMap &map) {
-    QString integrationId = map.value("integration_id").toString();
+void YioAPI::apiIntegrationRemove(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    QString integrationId = msg.value("integration_id").toString();
     qCDebug(CLASS_LC) << "Request for remove integration" << integrationId << client;
 
     QVariantMap response;
@@ -1039,7 +1593,8 @@ void YioAPI::apiIntegrationRemove(QWebSocket *client, const int &id, const QVari
     }
 }
 
-void YioAPI::apiEntitiesGetSupported(QWebSocket *client, const int &id) {
+void YioAPI::apiEntitiesGetSupported(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get supported entities" << client;
 
     QVariantMap response;
@@ -1052,7 +1607,8 @@ void YioAPI::apiEntitiesGetSupported(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiEntitiesGetLoaded(QWebSocket *client, const int &id) {
+void YioAPI::apiEntitiesGetLoaded(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get loaded entities" << client;
 
     QVariantMap response;
@@ -1066,63 +1622,73 @@ void YioAPI::apiEntitiesGetLoaded(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiEntitiesGetAvailable(QWebSocket *client, const int &id) {
+void YioAPI::apiEntitiesGetAvailable(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get all available entities" << client;
 
-    QVariantMap      response;
-    QVariantList     availableEntities;
-    QList<QObject *> integrations = m_integrations->list();
+    QVariantMap response;
+    QStringList integrationIds = m_integrations->listIds();
 
-    if (integrations.isEmpty()) {
+    if (integrationIds.isEmpty()) {
         apiSendResponse(client, id, false, response);
         return;
     }
 
-    for (int i = 0; i < integrations.length(); i++) {
-        if (integrations[i]) {
-            IntegrationInterface *ii = qobject_cast<IntegrationInterface *>(integrations[i]);
-            if (ii) {
-                availableEntities.append(ii->getAllAvailableEntities());
-            }
+    // the integrations are asked on their threads, the response is sent when the last one has answered
+    QPointer<QWebSocket>         socket(client);
+    QSharedPointer<QVariantList> availableEntities(new QVariantList());
+    QSharedPointer<int>          remaining(new int(1));
+    std::function<void()>        answered = [=]() {
+        if (--*remaining > 0 || socket.isNull()) {
+            return;
+        }
+        QVariantMap result;
+        result.insert("available_entities", *availableEntities);
+        apiSendResponse(socket, id, true, result);
+    };
+    for (const QString &integrationId : integrationIds) {
+        bool posted = m_integrations->scheduler()->post(integrationId, [=](IntegrationInterface *integration) {
+            QVariantList entities = integration->getAllAvailableEntities();
+            QMetaObject::invokeMethod(this,
+                                      [=]() {
+                                          availableEntities->append(entities);
+                                          answered();
+                                      },
+                                      Qt::QueuedConnection);
+        });
+        if (posted) {
+            ++*remaining;
         }
     }
-
-    if (availableEntities.isEmpty()) {
-        response.insert("available_entities", QVariantList());
-        apiSendResponse(client, id, true, response);
-        return;
-    }
-
-    response.insert("available_entities", availableEntities);
-    apiSendResponse(client, id, true, response);
+    answered();
 }
 
-void YioAPI::apiEntitiesAdd(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiEntitiesAdd(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for add entity" << client;
 
     QVariantMap response;
 
-    if (addEntity(map.value("config").toMap())) {
+    if (addEntity(msg.value("config").toObject().toVariantMap())) {
         apiSendResponse(client, id, true, response);
     } else {
         apiSendResponse(client, id, false, response);
     }
 }
 
-void YioAPI::apiEntitiesUpdate(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiEntitiesUpdate(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for update entity" << client;
 
     QVariantMap response;
 
-    if (updatEntity(map.value("config").toMap())) {
+    if (updatEntity(msg.value("config").toObject().toVariantMap())) {
         apiSendResponse(client, id, true, response);
     } else {
         apiSendResponse(client, id, false, response);
     }
 }
 
-void YioAPI::apiEntitiesRemove(QWebSocket *client, const int &id, const QVariantMap &map) {
-    QString entityId = map.value("entity_id").toString();
+void YioAPI::apiEntitiesRemove(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    QString entityId = msg.value("entity_id").toString();
     qCDebug(CLASS_LC) << "Request for remove entity" << entityId << client;
 
     QVariantMap response;
@@ -1134,7 +1700,142 @@ void YioAPI::apiEntitiesRemove(QWebSocket *client, const int &id, const QVariant
     }
 }
 
-void YioAPI::apiProfilesGetAll(QWebSocket *client, const int &id) {
+void YioAPI::apiEntitiesAddBatch(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    QVariantList entities = msg.value("entities").toArray().toVariantList();
+    qCDebug(CLASS_LC) << "Request for add entities" << entities.size() << client;
+
+    QVariantMap response;
+    QStringList errors;
+
+    if (addEntities(entities, errors)) {
+        apiSendResponse(client, id, true, response);
+    } else {
+        response.insert("errors", errors);
+        apiSendResponse(client, id, false, response);
+    }
+}
+
+void YioAPI::apiEntitiesRemoveBatch(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    QStringList entityIds = msg.value("entity_ids").toVariant().toStringList();
+    qCDebug(CLASS_LC) << "Request for remove entities" << entityIds.size() << client;
+
+    QVariantMap response;
+    QStringList errors;
+
+    if (removeEntities(entityIds, errors)) {
+        apiSendResponse(client, id, true, response);
+    } else {
+        response.insert("errors", errors);
+        apiSendResponse(client, id, false, response);
+    }
+}
+
+void YioAPI::apiEntitiesSubscribe(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    qCDebug(CLASS_LC) << "Request for subscribe to entities" << client;
+
+    if (!m_entitySourcesConnected) {
+        m_entitySourcesConnected = true;
+        connect(m_entities, &Entities::entityChanged, this, &YioAPI::onEntityChanged);
+    }
+
+    EntitySubscription subscription;
+    subscription.throttle = qMax(0, msg.value("throttle").toInt());
+    subscription.lastSent = 0;
+    for (const QJsonValue &entityId : msg.value("entities").toArray()) {
+        subscription.entityIds.insert(entityId.toString());
+    }
+
+    // the current state of the subscribed entities, followed by entities_changed messages with the changes only. Only
+    // a subscription of all entities needs all entity objects, otherwise just the requested ones are created.
+    QList<QObject *> objects;
+    if (subscription.entityIds.isEmpty()) {
+        objects = m_entities->list();
+    } else {
+        for (const QString &entityId : subscription.entityIds) {
+            objects.append(m_entities->get(entityId));
+        }
+    }
+    QVariantMap entities;
+    for (QObject *obj : objects) {
+        Entity *entity = qobject_cast<Entity *>(obj);
+        if (entity) {
+            entities.insert(entity->entity_id(), entity->getAttributes());
+        }
+    }
+
+    // subscribing again changes the subscription of the client
+    m_entitySubscribers.insert(client, subscription);
+
+    QVariantMap response;
+    response.insert("entities", entities);
+    apiSendResponse(client, id, true, response);
+}
+
+void YioAPI::apiEntitiesUnsubscribe(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
+    qCDebug(CLASS_LC) << "Request for unsubscribe from entities" << client;
+    QVariantMap response;
+
+    apiSendResponse(client, id, m_entitySubscribers.remove(client) > 0, response);
+}
+
+void YioAPI::apiLogsSubscribe(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    qCDebug(CLASS_LC) << "Request for subscribe to logs" << client;
+    QVariantMap response;
+
+    Logger *logger = Logger::getInstance();
+    if (logger == nullptr) {
+        response.insert("error", "Logger not available");
+        apiSendResponse(client, id, false, response);
+        return;
+    }
+
+    if (!m_logSourceConnected) {
+        m_logSourceConnected = true;
+        // emitted by the logger thread, the frames are sent from the GUI thread
+        connect(logger, &Logger::streamAvailable, this, [=]() {
+            if (!m_logSubscribers.isEmpty() && !m_logFrameTimer->isActive()) {
+                m_logFrameTimer->start();
+            }
+        });
+    }
+
+    LogSubscription subscription;
+    subscription.logLevel = logger->toMsgType(msg.value("level").toString("DEBUG"));
+    subscription.lost     = 0;
+    for (const QJsonValue &category : msg.value("categories").toArray()) {
+        subscription.categories.insert(category.toString());
+    }
+
+    // "history" starts with the last messages which were streamed before, while another client was subscribed
+    quint64 head        = logger->streamHead();
+    quint64 history     = static_cast<quint64>(qBound(0, msg.value("history").toInt(), Logger::STREAM_SIZE));
+    subscription.cursor = head - qMin(head, history);
+
+    // subscribing again changes the subscription of the client
+    m_logSubscribers.insert(client, subscription);
+    logger->setStreamEnabled(true);
+
+    apiSendResponse(client, id, true, response);
+    if (subscription.cursor < head && !m_logFrameTimer->isActive()) {
+        m_logFrameTimer->start();
+    }
+}
+
+void YioAPI::apiLogsUnsubscribe(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
+    qCDebug(CLASS_LC) << "Request for unsubscribe from logs" << client;
+    QVariantMap response;
+
+    bool subscribed = m_logSubscribers.remove(client) > 0;
+    if (m_logSubscribers.isEmpty() && Logger::getInstance() != nullptr) {
+        Logger::getInstance()->setStreamEnabled(false);
+    }
+    apiSendResponse(client, id, subscribed, response);
+}
+
+void YioAPI::apiProfilesGetAll(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get all profiles" << client;
 
     QVariantMap response;
@@ -1148,11 +1849,11 @@ void YioAPI::apiProfilesGetAll(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiProfilesSet(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiProfilesSet(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for set profile" << client;
 
     QVariantMap response;
-    QString     newProfileId = map.value("profile").toString();
+    QString     newProfileId = msg.value("profile").toString();
 
     if (!newProfileId.isEmpty()) {
         if (m_config->getProfileId() != newProfileId) {
@@ -1164,13 +1865,13 @@ void YioAPI::apiProfilesSet(QWebSocket *client, const int &id, const QVariantMap
     }
 }
 
-void YioAPI::apiProfilesAdd(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiProfilesAdd(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for add profile" << client;
 
     QVariantMap response;
     QVariantMap profiles = m_config->getProfiles();
 
-    QVariantMap newProfile = map.value("profile").toMap();
+    QVariantMap newProfile = msg.value("profile").toObject().toVariantMap();
     if (!newProfile.isEmpty()) {
         for (QVariantMap::const_iterator iter = newProfile.begin(); iter != newProfile.end(); ++iter) {
             profiles.insert(iter.key(), iter.value().toMap());
@@ -1184,13 +1885,13 @@ void YioAPI::apiProfilesAdd(QWebSocket *client, const int &id, const QVariantMap
     }
 }
 
-void YioAPI::apiProfilesUpdate(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiProfilesUpdate(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for update profile" << client;
 
     QVariantMap response;
-    if (!map.value("data").toMap().isEmpty()) {
+    if (!msg.value("data").toObject().toVariantMap().isEmpty()) {
         QVariantMap profiles = m_config->getProfiles();
-        profiles.insert(map.value("uuid").toString(), map.value("data").toMap());
+        profiles.insert(msg.value("uuid").toString(), msg.value("data").toObject().toVariantMap());
         m_config->setProfiles(profiles);
         apiSendResponse(client, id, true, response);
     } else {
@@ -1198,7 +1899,7 @@ void YioAPI::apiProfilesUpdate(QWebSocket *client, const int &id, const QVariant
     }
 }
 
-void YioAPI::apiProfilesRemove(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiProfilesRemove(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for remove profile" << client;
 
     bool success = false;
@@ -1214,7 +1915,7 @@ void YioAPI::apiProfilesRemove(QWebSocket *client, const int &id, const QVariant
     }
 
     for (QVariantMap::const_iterator iter = profiles.begin(); iter != profiles.end(); ++iter) {
-        if (iter.key() == map.value("profile_id").toString()) {
+        if (iter.key() == msg.value("profile_id").toString()) {
             profiles.remove(iter.key());
             success = true;
             break;
@@ -1230,7 +1931,8 @@ void YioAPI::apiProfilesRemove(QWebSocket *client, const int &id, const QVariant
     }
 }
 
-void YioAPI::apiPagesGetAll(QWebSocket *client, const int &id) {
+void YioAPI::apiPagesGetAll(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get all pages" << client;
 
     QVariantMap response;
@@ -1243,12 +1945,12 @@ void YioAPI::apiPagesGetAll(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiPagesAdd(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiPagesAdd(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for add a page" << client;
 
     QVariantMap response;
     QVariantMap pages   = m_config->getPages();
-    QVariantMap newPage = map.value("page").toMap();
+    QVariantMap newPage = msg.value("page").toObject().toVariantMap();
 
     if (!newPage.isEmpty()) {
         for (QVariantMap::const_iterator iter = newPage.begin(); iter != newPage.end(); ++iter) {
@@ -1262,13 +1964,13 @@ void YioAPI::apiPagesAdd(QWebSocket *client, const int &id, const QVariantMap &m
     }
 }
 
-void YioAPI::apiPagesUpdate(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiPagesUpdate(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for update page" << client;
 
     QVariantMap response;
-    if (!map.value("data").toMap().isEmpty()) {
+    if (!msg.value("data").toObject().toVariantMap().isEmpty()) {
         QVariantMap pages = m_config->getPages();
-        pages.insert(map.value("uuid").toString(), map.value("data").toMap());
+        pages.insert(msg.value("uuid").toString(), msg.value("data").toObject().toVariantMap());
         m_config->setPages(pages);
         apiSendResponse(client, id, true, response);
     } else {
@@ -1276,7 +1978,7 @@ void YioAPI::apiPagesUpdate(QWebSocket *client, const int &id, const QVariantMap
     }
 }
 
-void YioAPI::apiPagesRemove(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiPagesRemove(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for remove page" << client;
 
     bool success = false;
@@ -1291,7 +1993,7 @@ void YioAPI::apiPagesRemove(QWebSocket *client, const int &id, const QVariantMap
         QStringList pages   = profile.value("pages").toStringList();
 
         for (int i = 0; i < pages.length(); i++) {
-            if (pages[i] == map.value("page_id").toString()) {
+            if (pages[i] == msg.value("page_id").toString()) {
                 pages.removeAt(i);
                 break;
             }
@@ -1307,7 +2009,7 @@ void YioAPI::apiPagesRemove(QWebSocket *client, const int &id, const QVariantMap
     QVariantMap pages = m_config->getPages();
 
     for (QVariantMap::const_iterator iter = pages.begin(); iter != pages.end(); ++iter) {
-        if (iter.key() == map.value("page_id").toString()) {
+        if (iter.key() == msg.value("page_id").toString()) {
             pages.remove(iter.key());
             m_config->setPages(pages);
             success = true;
@@ -1322,7 +2024,8 @@ void YioAPI::apiPagesRemove(QWebSocket *client, const int &id, const QVariantMap
     }
 }
 
-void YioAPI::apiGroupsGetAll(QWebSocket *client, const int &id) {
+void YioAPI::apiGroupsGetAll(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get all groups" << client;
 
     QVariantMap response;
@@ -1335,12 +2038,12 @@ void YioAPI::apiGroupsGetAll(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiGroupsAdd(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiGroupsAdd(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for add a group" << client;
 
     QVariantMap response;
     QVariantMap groups   = m_config->getGroups();
-    QVariantMap newGroup = map.value("group").toMap();
+    QVariantMap newGroup = msg.value("group").toObject().toVariantMap();
 
     if (!newGroup.isEmpty()) {
         for (QVariantMap::const_iterator iter = newGroup.begin(); iter != newGroup.end(); ++iter) {
@@ -1354,13 +2057,13 @@ void YioAPI::apiGroupsAdd(QWebSocket *client, const int &id, const QVariantMap &
     }
 }
 
-void YioAPI::apiGroupsUpdate(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiGroupsUpdate(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for update group" << client;
 
     QVariantMap response;
-    if (!map.value("data").toMap().isEmpty()) {
+    if (!msg.value("data").toObject().toVariantMap().isEmpty()) {
         QVariantMap groups = m_config->getGroups();
-        groups.insert(map.value("uuid").toString(), map.value("data").toMap());
+        groups.insert(msg.value("uuid").toString(), msg.value("data").toObject().toVariantMap());
         m_config->setGroups(groups);
         apiSendResponse(client, id, true, response);
     } else {
@@ -1368,7 +2071,7 @@ void YioAPI::apiGroupsUpdate(QWebSocket *client, const int &id, const QVariantMa
     }
 }
 
-void YioAPI::apiGroupsRemove(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiGroupsRemove(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for remove group" << client;
 
     bool success = false;
@@ -1377,7 +2080,7 @@ void YioAPI::apiGroupsRemove(QWebSocket *client, const int &id, const QVariantMa
     QVariantMap groups = m_config->getGroups();
 
     for (QVariantMap::const_iterator iter = groups.begin(); iter != groups.end(); ++iter) {
-        if (iter.key() == map.value("group_id").toString()) {
+        if (iter.key() == msg.value("group_id").toString()) {
             groups.remove(iter.key());
             m_config->setGroups(groups);
             success = true;
@@ -1392,7 +2095,8 @@ void YioAPI::apiGroupsRemove(QWebSocket *client, const int &id, const QVariantMa
     }
 }
 
-void YioAPI::apiSettingsGetAllLanguages(QWebSocket *client, const int &id) {
+void YioAPI::apiSettingsGetAllLanguages(QWebSocket *client, const int &id, const QJsonObject &msg) {
+    Q_UNUSED(msg)
     qCDebug(CLASS_LC) << "Request for get all languages" << client;
 
     QVariantMap  response;
@@ -1405,29 +2109,29 @@ void YioAPI::apiSettingsGetAllLanguages(QWebSocket *client, const int &id) {
     }
 }
 
-void YioAPI::apiSettingsSetLanguage(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiSettingsSetLanguage(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for set a language" << client;
 
     QVariantMap response;
-    if (!map.value("language").toString().isEmpty()) {
+    if (!msg.value("language").toString().isEmpty()) {
         // need to check if the data is valid
         QVariantMap settings = m_config->getSettings();
-        settings.insert("language", map.value("language").toString());
+        settings.insert("language", msg.value("language").toString());
         m_config->setSettings(settings);
-        TranslationHandler::getInstance()->selectLanguage(map.value("language").toString());
+        TranslationHandler::getInstance()->selectLanguage(msg.value("language").toString());
         apiSendResponse(client, id, true, response);
     } else {
         apiSendResponse(client, id, false, response);
     }
 }
 
-void YioAPI::apiSettingsSetAutoBrightness(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiSettingsSetAutoBrightness(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for set auto brightness" << client;
 
     QVariantMap response;
     QVariantMap settings = m_config->getSettings();
-    if (map.value("value").toBool() || !map.value("value").toBool()) {
-        settings.insert("autobrightness", map.value("value").toBool());
+    if (msg.value("value").toBool() || !msg.value("value").toBool()) {
+        settings.insert("autobrightness", msg.value("value").toBool());
         m_config->setSettings(settings);
         apiSendResponse(client, id, true, response);
     } else {
@@ -1435,13 +2139,13 @@ void YioAPI::apiSettingsSetAutoBrightness(QWebSocket *client, const int &id, con
     }
 }
 
-void YioAPI::apiSettingsSetDarkMode(QWebSocket *client, const int &id, const QVariantMap &map) {
+void YioAPI::apiSettingsSetDarkMode(QWebSocket *client, const int &id, const QJsonObject &msg) {
     qCDebug(CLASS_LC) << "Request for set dark mode" << client;
 
     QVariantMap response;
     QVariantMap uiConfig = m_config->getUIConfig();
-    if (map.value("value").toBool() || !map.value("value").toBool()) {
-        uiConfig.insert("darkmode", map.value("value").toBool());
+    if (msg.value("value").toBool() || !msg.value("value").toBool()) {
+        uiConfig.insert("darkmode", msg.value("value").toBool());
         m_config->setUIConfig(uiConfig);
         apiSendResponse(client, id, true, response);
     } else {
@@ -22,8 +22,14 @@
 #pragma once
 
 #include <QCryptographicHash>
+#include <QCborStreamReader>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QObject>
 #include <QQmlApplicationEngine>
+#include <QSet>
+#include <QTimer>
 #include <QtWebSockets/QWebSocket>
 #include <QtWebSockets/QWebSocketServer>
 
@@ -59,6 +65,24 @@ class YioAPI : public YioAPIInterface {
     bool updatEntity(QVariantMap entity) override;
     bool removeEntity(QString entityId) override;
 
+    /**
+     * @brief addEntities Adds all entities with a single config change and loads them.
+     * Either all or none of the entities are added.
+     * @param entities The entity configurations including the entity type in the "type" key
+     * @param errors Returns the reason for each entity which could not be added
+     * @return true if all entities were added
+     */
+    bool addEntities(const QVariantList& entities, QStringList& errors);  // NOLINT we do not want a pointer for errors
+
+    /**
+     * @brief removeEntities Removes all entities from the config, groups and favorites with a single config change.
+     * Either all or none of the entities are removed.
+     * @param entityIds The entity_ids of the entities to remove
+     * @param errors Returns the reason for each entity which could not be removed
+     * @return true if all entities were removed
+     */
+    bool removeEntities(const QStringList& entityIds, QStringList& errors);  // NOLINT we do not want a pointer
+
     Q_INVOKABLE bool addIntegration(QVariantMap integration);
     bool             updateIntegration(QVariantMap integration);
     bool             removeIntegration(QString integrationId);
@@ -84,15 +108,102 @@ class YioAPI : public YioAPIInterface {
     void onClosed();
     void onNewConnection();
     void processMessage(QString message);
+    void processBinaryMessage(QByteArray message);
     void onClientDisconnected();
 
  private:
     QWebSocketServer*       m_server;
-    QMap<QWebSocket*, bool> m_clients;  // websocket client, true if authentication was successful
+    QMap<QWebSocket*, bool> m_clients;        // websocket client, true if authentication was successful
+    QSet<QWebSocket*>       m_binaryClients;  // clients using the CBOR encoding instead of JSON
+
+    // EVENTS
+    // Event topics a client can subscribe to, used as bit mask
+    enum EventTopic {
+        TOPIC_CONFIG   = 0x01,
+        TOPIC_ENTITIES = 0x02,
+        TOPIC_BATTERY  = 0x04,
+        TOPIC_BUTTONS  = 0x08,
+        TOPIC_STANDBY  = 0x10
+    };
+
+    struct EventSubscription {
+        int  topics;  // EventTopic mask
+        bool batch;   // send all events of a batch window in one message
+    };
+
+    struct PendingEvent {
+        int         topic;  // EventTopic
+        QString     event;
+        QVariantMap data;
+    };
+
+    static const int EVENT_BATCH_DELAY = 20;  // ms to collect events before sending them to the clients
+
+    QHash<QWebSocket*, EventSubscription> m_eventSubscribers;
+    QList<PendingEvent>                   m_pendingEvents;
+    QTimer*                               m_eventTimer;
+    bool                                  m_eventSourcesConnected = false;
+
+    /**
+     * @brief connectEventSources Connects the signals of all event topics. Done once with the first subscriber.
+     */
+    void connectEventSources();
+
+    /**
+     * @brief publishEvent Queues the event for all subscribers of the topic. Queued events are sent after the batch
+     * delay, each event is serialized only once per encoding.
+     */
+    void publishEvent(EventTopic topic, const QString& event, const QVariantMap& data = QVariantMap());
+    void onEventTimeout();
+
+    static int eventTopics(const QJsonArray& topics);
+
+    // ENTITY STATE STREAMING
+    struct EntitySubscription {
+        QSet<QString>             entityIds;  // empty: all entities
+        int                       throttle;   // minimum ms between two updates, 0: every frame
+        qint64                    lastSent;   // ms since epoch
+        QHash<QString, QSet<int>> pending;    // entity_id -> changed attribute indexes not yet sent
+    };
+
+    static const int ENTITY_FRAME_INTERVAL = 16;  // ms to coalesce entity changes, about one display frame
+
+    QHash<QWebSocket*, EntitySubscription> m_entitySubscribers;
+    QHash<QString, QSet<int>>              m_changedEntities;  // entity_id -> changed attribute indexes of the frame
+    QTimer*                                m_entityFrameTimer;
+    bool                                   m_entitySourcesConnected = false;
+
+    void onEntityChanged(Entity* entity, int attrIndex);
+    void onEntityFrameTimeout();
+
+    // LOG STREAMING
+    struct LogSubscription {
+        quint64       cursor;      // next entry of the log stream
+        int           logLevel;    // minimum message type
+        QSet<QString> categories;  // empty: all categories
+        quint64       lost;        // entries overwritten before they were sent, reported with the next frame
+    };
 
-    QList<QWebSocket*> m_subscribed_clients;
-    QObject*           m_context;
-    void               subscribeOnSignalEvent(const QString& event);
+    static const int LOG_FRAME_INTERVAL = 100;  // ms to collect log messages before sending them to the clients
+    static const int LOG_FRAME_SIZE     = 250;  // maximum log messages of one frame
+
+    QHash<QWebSocket*, LogSubscription> m_logSubscribers;
+    QTimer*                             m_logFrameTimer;
+    bool                                m_logSourceConnected = false;
+
+    void onLogFrameTimeout();
+
+    /**
+     * @brief appendCborArrayHeader Appends the CBOR header of an array with count items, the items are appended as
+     * already serialized CBOR values.
+     */
+    static void appendCborArrayHeader(QByteArray* data, int count);
+
+    /**
+     * @brief readCborValue Reads the current CBOR value of the stream and converts it to JSON in one pass, without an
+     * intermediate QCborValue. Byte arrays are converted to base64url strings like QCborValue::toJsonValue does.
+     */
+    static QJsonValue readCborValue(QCborStreamReader* reader);
 
     bool m_running = false;
 
@@ -118,52 +229,84 @@ class YioAPI : public YioAPIInterface {
     Config*       m_config;
 
     // API CALLS
+    // All message handlers share the same signature so they can be dispatched from the handler table
+    typedef void (YioAPI::*ApiHandler)(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    QHash<QString, ApiHandler> m_apiHandlers;  // message type -> handler
+
+    /**
+     * @brief registerApiHandler Registers the handler for the given message type. New API calls must be added here
+     * instead of extending processMessage.
+     */
+    void registerApiHandler(const QString& type, ApiHandler handler);
+    void registerApiHandlers();
+
+    void dispatchMessage(QWebSocket* client, const QJsonObject& msg);
+
+    /**
+     * @brief sendToClient Sends the message in the encoding of the client: CBOR if the client sent a binary message or
+     * requested "encoding": "cbor" during authentication, JSON otherwise.
+     * Used for the replies to API calls. Events, entity frames and log frames are serialized directly to CBOR or JSON.
+     */
+    void sendToClient(QWebSocket* client, const QVariantMap& message);
+
     void apiSendResponse(QWebSocket* client, const int& id, const bool& success, QVariantMap response);
 
-    void apiAuth(QWebSocket* client, const QVariantMap& map);
-
-    void apiSystemButton(const int& id, const QVariantMap& map);
-    void apiSystemReboot(QWebSocket* client, const int& id);
-    void apiSystemShutdown(QWebSocket* client, const int& id);
-    void apiSystemSubscribeToEvents(QWebSocket* client, const int& id);
-    void apiSystemUnsubscribeFromEvents(QWebSocket* client, const int& id);
-
-    void apiGetConfig(QWebSocket* client, const int& id);
-    void apiSetConfig(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiIntegrationsDiscover(QWebSocket* client, const int& id);
-    void apiIntegrationsGetSupported(QWebSocket* client, const int& id);
-    void apiIntegrationsGetLoaded(QWebSocket* client, const int& id);
-    void apiIntegrationGetData(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiIntegrationAdd(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiIntegrationUpdate(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiIntegrationRemove(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiEntitiesGetSupported(QWebSocket* client, const int& id);
-    void apiEntitiesGetLoaded(QWebSocket* client, const int& id);
-    void apiEntitiesGetAvailable(QWebSocket* client, const int& id);
-    void apiEntitiesAdd(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiEntitiesUpdate(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiEntitiesRemove(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiProfilesGetAll(QWebSocket* client, const int& id);
-    void apiProfilesSet(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiProfilesAdd(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiProfilesUpdate(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiProfilesRemove(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiPagesGetAll(QWebSocket* client, const int& id);
-    void apiPagesAdd(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiPagesUpdate(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiPagesRemove(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiGroupsGetAll(QWebSocket* client, const int& id);
-    void apiGroupsAdd(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiGroupsUpdate(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiGroupsRemove(QWebSocket* client, const int& id, const QVariantMap& map);
-
-    void apiSettingsGetAllLanguages(QWebSocket* client, const int& id);
-    void apiSettingsSetLanguage(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiSettingsSetAutoBrightness(QWebSocket* client, const int& id, const QVariantMap& map);
-    void apiSettingsSetDarkMode(QWebSocket* client, const int& id, const QVariantMap& map);
+    void apiAuth(QWebSocket* client, const QJsonObject& msg);
+
+    void apiSystemButton(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemReboot(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemShutdown(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemSubscribeToEvents(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemUnsubscribeFromEvents(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemGetLogs(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSystemGetWakeLatency(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiGetConfig(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSetConfig(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiPatchConfig(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiIntegrationsDiscover(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationsGetSupported(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationsGetLoaded(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationsGetLoad(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationGetData(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationAdd(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationUpdate(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiIntegrationRemove(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiEntitiesGetSupported(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesGetLoaded(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesGetAvailable(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesAdd(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesUpdate(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesRemove(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesAddBatch(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesRemoveBatch(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesSubscribe(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiEntitiesUnsubscribe(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiLogsSubscribe(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiLogsUnsubscribe(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiProfilesGetAll(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiProfilesSet(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiProfilesAdd(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiProfilesUpdate(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiProfilesRemove(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiPagesGetAll(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiPagesAdd(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiPagesUpdate(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiPagesRemove(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiGroupsGetAll(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiGroupsAdd(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiGroupsUpdate(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiGroupsRemove(QWebSocket* client, const int& id, const QJsonObject& msg);
+
+    void apiSettingsGetAllLanguages(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSettingsSetLanguage(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSettingsSetAutoBrightness(QWebSocket* client, const int& id, const QJsonObject& msg);
+    void apiSettingsSetDarkMode(QWebSocket* client, const int& id, const QJsonObject& msg);
 };